@@ -0,0 +1,105 @@
+#include "meshroomMaya/core/MVGParticleSelection.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace meshroomMaya;
+
+namespace
+{ // empty namespace
+
+static const std::string CLOUD_NAME = "mvgPointCloud";
+
+/// MEL command built by the former MVGMayaUtil::selectParticles, one token per point
+std::string getPerPointSelectCommand(const std::string& objectName, const std::set<int>& points)
+{
+    std::ostringstream s;
+    s << "select -r ";
+    for(std::set<int>::const_iterator it = points.begin(); it != points.end(); ++it)
+        s << objectName << ".pt[" << *it << "] ";
+    s << ";";
+    return s.str();
+}
+
+/**
+ * Random selection of the given size among the first (size / density) points, density being
+ * the probability of a point to be selected: 1 gives a single range, low densities give
+ * isolated points as when selecting the points seen by a few cameras of a large reconstruction.
+ */
+void generateSelection(const size_t size, const double density, std::set<int>& points)
+{
+    std::mt19937 generator(0);
+    std::vector<int> candidates(static_cast<size_t>(size / density));
+    for(size_t i = 0; i < candidates.size(); ++i)
+        candidates[i] = static_cast<int>(i);
+    std::shuffle(candidates.begin(), candidates.end(), generator);
+    points.clear();
+    points.insert(candidates.begin(), candidates.begin() + size);
+}
+
+/// median time of the command build, in milliseconds
+template <typename Builder>
+double timeCommand(Builder builder, const std::set<int>& points, const size_t repetitions,
+                   size_t& commandLength)
+{
+    std::vector<double> times;
+    for(size_t r = 0; r < repetitions; ++r)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const std::string command = builder(CLOUD_NAME, points);
+        times.push_back(std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start).count());
+        commandLength = command.size();
+    }
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+} // empty namespace
+
+/**
+ * Compare the MEL particle selection command built with pt[first:last] ranges (the fallback of
+ * MVGMayaUtil::selectParticles) with the former one token per point command, on selections of
+ * 10k, 100k and 1M points with a decreasing density of contiguous indexes.
+ * Reports the median build time and the command length. The component based selection and the
+ * MEL parsing by Maya are not measured, as they need a Maya session.
+ * Usage: benchParticleSelection [repetitions]
+ */
+int main(int argc, char** argv)
+{
+    const size_t repetitions = std::max<size_t>(argc > 1 ? std::strtoul(argv[1], NULL, 10) : 5, 1);
+
+    const size_t sizes[] = {10000, 100000, 1000000};
+    const double densities[] = {1.0, 0.5, 0.1};
+    std::cout << std::setw(9) << "points" << std::setw(9) << "density" << std::setw(14)
+              << "points (ms)" << std::setw(14) << "ranges (ms)" << std::setw(14)
+              << "points (MB)" << std::setw(14) << "ranges (MB)" << std::endl;
+    for(const size_t size : sizes)
+    {
+        for(const double density : densities)
+        {
+            std::set<int> points;
+            generateSelection(size, density, points);
+            size_t perPointLength = 0;
+            size_t rangesLength = 0;
+            const double perPointTime =
+                timeCommand(getPerPointSelectCommand, points, repetitions, perPointLength);
+            const double rangesTime =
+                timeCommand(getSelectParticlesCommand, points, repetitions, rangesLength);
+            std::cout << std::setw(9) << size << std::setw(9) << std::fixed
+                      << std::setprecision(1) << density << std::setw(14)
+                      << std::setprecision(2) << perPointTime << std::setw(14) << rangesTime
+                      << std::setw(14) << std::setprecision(3)
+                      << perPointLength / (1024.0 * 1024.0) << std::setw(14)
+                      << rangesLength / (1024.0 * 1024.0) << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#include "meshroomMaya/core/MVGPlaneEstimator.hpp"
+#include "meshroomMaya/core/MVGPlaneKernel.hpp"
+#include <aliceVision/robustEstimation/leastMedianOfSquares.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace meshroomMaya;
+
+namespace
+{ // empty namespace
+
+/// noise of the reconstructed points, relative to the face size
+static const double POINTS_NOISE = 0.005;
+/// normal error under which the estimated plane is considered as correct
+static const double MAX_ANGLE_ERROR = 2.0;
+
+/**
+ * Points enclosed by a face drawn over a wall: noisy points of the wall itself, and outliers
+ * from the objects seen through the same image area. Half of the outliers lie on a surface
+ * slightly in front of the wall (furniture, frames: structured outliers), the other half are
+ * spread in the volume in front of it.
+ * Inlier points get higher weights (number of observations) on average.
+ * @param[out] points : enclosed points, one per column
+ * @param[out] weights : quality of each point
+ * @param[out] plane : ground truth plane
+ */
+void generateEnclosure(std::mt19937& generator, const size_t pointsCount,
+                       const double outlierRatio, aliceVision::Mat& points,
+                       std::vector<double>& weights, PlaneKernel::Model& plane)
+{
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::normal_distribution<double> noise(0.0, POINTS_NOISE);
+
+    // random wall orientation, face of size 2x2 around the origin
+    const aliceVision::Vec3 normal =
+        aliceVision::Vec3(uniform(generator), uniform(generator), uniform(generator)).normalized();
+    const aliceVision::Vec3 u = normal.unitOrthogonal();
+    const aliceVision::Vec3 v = normal.cross(u);
+    const aliceVision::Vec3 origin(uniform(generator), uniform(generator), uniform(generator));
+    plane.head<3>() = normal;
+    plane(3) = -normal.dot(origin);
+
+    const size_t outliersCount = static_cast<size_t>(outlierRatio * pointsCount);
+    points.resize(3, pointsCount);
+    weights.resize(pointsCount);
+    for(size_t i = 0; i < pointsCount; ++i)
+    {
+        aliceVision::Vec3 point = origin + uniform(generator) * u + uniform(generator) * v;
+        if(i >= outliersCount)
+        {
+            point += noise(generator) * normal;
+            weights[i] = 2.0 + 8.0 * (0.5 + 0.5 * uniform(generator));
+        }
+        else
+        {
+            if(i % 2 == 0) // structured: surface in front of the wall, slightly tilted
+                point += (0.2 + 0.1 * u.dot(point - origin) + noise(generator)) * normal;
+            else
+                point += (0.5 + 0.5 * uniform(generator)) * normal;
+            weights[i] = 2.0 + 4.0 * (0.5 + 0.5 * uniform(generator));
+        }
+        points.col(i) = point;
+    }
+}
+
+/// angle between the plane normals, in degrees
+double getAngleError(const PlaneKernel::Model& estimated, const PlaneKernel::Model& reference)
+{
+    const double cosine = std::abs(estimated.head<3>().normalized().dot(reference.head<3>()));
+    return std::acos(std::min(cosine, 1.0)) * 180.0 / M_PI;
+}
+
+/// distance to the estimated plane of the ground truth plane point closest to the origin, which
+/// lies near the face
+double getOffsetError(const PlaneKernel::Model& estimated, const PlaneKernel::Model& reference)
+{
+    const aliceVision::Vec3 center = -reference(3) * reference.head<3>();
+    const double normalLength = estimated.head<3>().norm();
+    if(normalLength == 0.0)
+        return std::numeric_limits<double>::infinity();
+    return std::abs(estimated.head<3>().dot(center) + estimated(3)) / normalLength;
+}
+
+double median(std::vector<double>& values)
+{
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+} // empty namespace
+
+/**
+ * Compare the plane estimators used to place faces (see MVGGeometryUtil::computePlane) on
+ * synthetic face enclosures with an increasing outlier ratio: LMedS (aliceVision), adaptive
+ * RANSAC and PROSAC (robustPlane::estimate). Reports the median normal and offset errors, the
+ * ratio of planes within 2 degrees of the ground truth and the median latency.
+ * Usage: benchPlaneEstimator [pointsCount] [trials]
+ */
+int main(int argc, char** argv)
+{
+    const size_t pointsCount = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 500;
+    const size_t trials = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 200;
+    if(pointsCount < PlaneKernel::MINIMUM_SAMPLES || trials == 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [pointsCount] [trials]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const char* methodNames[] = {"LMedS", "RANSAC", "PROSAC"};
+    const double outlierRatios[] = {0.1, 0.3, 0.5, 0.7};
+    std::cout << pointsCount << " points per enclosure, " << trials << " trials" << std::endl;
+    std::cout << std::setw(9) << "outliers" << std::setw(8) << "method" << std::setw(12)
+              << "angle (deg)" << std::setw(10) << "offset" << std::setw(10) << "correct"
+              << std::setw(12) << "time (us)" << std::endl;
+    for(const double outlierRatio : outlierRatios)
+    {
+        for(int method = MVGPlaneEstimatorOptions::eMethodLMedS;
+            method <= MVGPlaneEstimatorOptions::eMethodProsac; ++method)
+        {
+            MVGPlaneEstimatorOptions options;
+            options.method = static_cast<MVGPlaneEstimatorOptions::EMethod>(method);
+            // same enclosures for every method
+            std::mt19937 generator(0);
+            std::vector<double> angleErrors, offsetErrors, times;
+            size_t correctCount = 0;
+            for(size_t t = 0; t < trials; ++t)
+            {
+                aliceVision::Mat points;
+                std::vector<double> weights;
+                PlaneKernel::Model reference;
+                generateEnclosure(generator, pointsCount, outlierRatio, points, weights,
+                                  reference);
+                PlaneKernel kernel(points);
+                PlaneKernel::Model model = PlaneKernel::Model::Zero();
+                const std::chrono::steady_clock::time_point start =
+                    std::chrono::steady_clock::now();
+                if(options.method == MVGPlaneEstimatorOptions::eMethodLMedS)
+                {
+                    double outlierThreshold = std::numeric_limits<double>::infinity();
+                    aliceVision::robustEstimation::LeastMedianOfSquares(kernel, &model,
+                                                                        &outlierThreshold);
+                }
+                else
+                    robustPlane::estimate(kernel, options, weights, model);
+                times.push_back(std::chrono::duration<double, std::micro>(
+                                    std::chrono::steady_clock::now() - start).count());
+                angleErrors.push_back(getAngleError(model, reference));
+                offsetErrors.push_back(getOffsetError(model, reference));
+                if(angleErrors.back() < MAX_ANGLE_ERROR)
+                    ++correctCount;
+            }
+            std::cout << std::setw(8) << std::fixed << std::setprecision(0)
+                      << outlierRatio * 100.0 << "%" << std::setw(8) << methodNames[method]
+                      << std::setw(12) << std::setprecision(3) << median(angleErrors)
+                      << std::setw(10) << std::setprecision(4) << median(offsetErrors)
+                      << std::setw(9) << std::setprecision(1)
+                      << 100.0 * correctCount / trials << "%" << std::setw(12)
+                      << std::setprecision(1) << median(times) << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+#include "meshroomMaya/core/MVGVisibilityGraph.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace meshroomMaya;
+
+namespace
+{ // empty namespace
+
+/// observations are stored as (viewID, featureID) pairs, as in the abc point cloud
+static const size_t STRIDE = 2;
+
+/**
+ * Synthetic point cloud visibility, close to a real reconstruction: each point is seen by
+ * 2 to 8 cameras taken around a random one (cameras see overlapping parts of the scene), and
+ * view ids are sparse random integers.
+ * @param[out] visibilitySizes : number of observations of each point
+ * @param[out] visibilityIds : (viewID, featureID) records, grouped by point
+ */
+void generateVisibility(const size_t pointsCount, const size_t camerasCount,
+                        std::vector<int>& visibilitySizes, std::vector<int>& visibilityIds)
+{
+    std::mt19937 generator(0);
+    std::vector<int> viewIds(camerasCount);
+    std::uniform_int_distribution<int> viewIdDistribution(0, std::numeric_limits<int>::max());
+    for(size_t c = 0; c < camerasCount; ++c)
+        viewIds[c] = viewIdDistribution(generator);
+
+    std::uniform_int_distribution<size_t> cameraDistribution(0, camerasCount - 1);
+    std::uniform_int_distribution<int> sizeDistribution(2, 8);
+    visibilitySizes.resize(pointsCount);
+    visibilityIds.clear();
+    visibilityIds.reserve(pointsCount * 5 * STRIDE);
+    for(size_t p = 0; p < pointsCount; ++p)
+    {
+        const int size = sizeDistribution(generator);
+        const size_t firstCamera = cameraDistribution(generator);
+        visibilitySizes[p] = size;
+        for(int i = 0; i < size; ++i)
+        {
+            visibilityIds.push_back(viewIds[(firstCamera + 3 * i) % camerasCount]);
+            visibilityIds.push_back(static_cast<int>(p));
+        }
+    }
+}
+
+} // empty namespace
+
+/**
+ * Build the visibility graph of a synthetic reconstruction (2M points and 10M observations by
+ * default) with an increasing number of threads, and report the median build time and the
+ * speedup over one thread.
+ * Usage: benchVisibilityGraph [pointsCount] [camerasCount] [repetitions]
+ */
+int main(int argc, char** argv)
+{
+    const size_t pointsCount = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 2000000;
+    const size_t camerasCount = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 1500;
+    const size_t repetitions = std::max<size_t>(argc > 3 ? std::strtoul(argv[3], NULL, 10) : 5, 1);
+    if(pointsCount == 0 || camerasCount == 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [pointsCount] [camerasCount] [repetitions]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<int> visibilitySizes;
+    std::vector<int> visibilityIds;
+    generateVisibility(pointsCount, camerasCount, visibilitySizes, visibilityIds);
+    std::cout << pointsCount << " points, " << visibilityIds.size() / STRIDE
+              << " observations, " << camerasCount << " cameras" << std::endl;
+
+    const size_t coresCount = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<size_t> threadsCounts;
+    for(size_t threads = 1; threads < coresCount; threads *= 2)
+        threadsCounts.push_back(threads);
+    threadsCounts.push_back(coresCount);
+
+    double singleThreadTime = 0.0;
+    size_t referenceObservations = 0;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "time (ms)" << std::setw(10)
+              << "speedup" << std::endl;
+    for(size_t t = 0; t < threadsCounts.size(); ++t)
+    {
+        std::vector<double> times;
+        for(size_t r = 0; r < repetitions; ++r)
+        {
+            MVGVisibilityGraph graph;
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            graph.buildFromPointVisibility(&visibilitySizes[0], visibilitySizes.size(),
+                                           &visibilityIds[0], visibilityIds.size(), STRIDE,
+                                           threadsCounts[t]);
+            times.push_back(std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start).count());
+            // every threads count must give the same graph
+            if(referenceObservations == 0)
+                referenceObservations = graph.getObservationsCount();
+            if(graph.getObservationsCount() != referenceObservations ||
+               graph.getCamerasCount() != camerasCount)
+            {
+                std::cerr << "Inconsistent graph with " << threadsCounts[t] << " threads"
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        const double medianTime = times[times.size() / 2];
+        if(t == 0)
+            singleThreadTime = medianTime;
+        std::cout << std::setw(8) << threadsCounts[t] << std::setw(12) << std::fixed
+                  << std::setprecision(1) << medianTime << std::setw(10) << std::setprecision(2)
+                  << singleThreadTime / medianTime << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -17,6 +17,7 @@
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MItDependencyNodes.h>
 #include <maya/MDagPathArray.h>
+#include <algorithm>
 
 namespace meshroomMaya
 {
@@ -33,6 +34,9 @@ MString MVGCamera::_MVG_IMAGE_PATH = "mvg_imagePath";
 MString MVGCamera::_MVG_THUMBNAIL_PATH = "mvg_thumbnailPath";
 MString MVGCamera::_MVG_SENSOR_SIZE = "mvg_sensorSizePix";
 
+MVGVisibilityGraph MVGCamera::_visibilityGraph;
+bool MVGCamera::_visibilityGraphLoaded = false;
+
 MVGCamera::MVGCamera()
     : MVGNodeWrapper()
 {
@@ -108,7 +112,12 @@ bool MVGCamera::isValid() const
     return true;
 }
 
-MVGCamera MVGCamera::create(MDagPath& cameraDagPath, std::map<int, MIntArray>& itemsPerCamera)
+/**
+ * @param[in] cameraDagPath
+ * @param[in] visibilityGraph : visibility of the whole reconstruction, the points visible by this
+ * camera are persisted in its mvg_visibleItems attribute
+ */
+MVGCamera MVGCamera::create(MDagPath& cameraDagPath, const MVGVisibilityGraph& visibilityGraph)
 {
     MStatus status;
 
@@ -140,7 +149,11 @@ MVGCamera MVGCamera::create(MDagPath& cameraDagPath, std::map<int, MIntArray>& i
     dagModifier.doIt();
 
     // Set MVG attributes
-    MVGMayaUtil::setIntArrayAttribute(cameraNode, MVGCamera::_MVG_ITEMS, itemsPerCamera[viewID]);
+    const MVGVisibilityGraph::Range points = visibilityGraph.getCameraPoints(viewID);
+    MIntArray visibleIndexes;
+    if(!points.empty())
+        visibleIndexes = MIntArray(points.begin(), points.size());
+    MVGMayaUtil::setIntArrayAttribute(cameraNode, MVGCamera::_MVG_ITEMS, visibleIndexes);
 
     // create, reparent & connect image plane
     MString cmd;
@@ -180,6 +193,61 @@ std::vector<MVGCamera> MVGCamera::getCameras()
     return list;
 }
 
+/**
+ * Build the visibility graph from the mvg_visibleItems attribute of every camera.
+ * Only needed when the cameras were not created in this session (scene reopened).
+ */
+// static
+MStatus MVGCamera::loadVisibilityGraph()
+{
+    MStatus status;
+    std::vector<int> observationCameraIds;
+    std::vector<int> observationPointIds;
+    const std::vector<MVGCamera> cameras = getCameras();
+    for(size_t i = 0; i < cameras.size(); ++i)
+    {
+        const int cameraId = cameras[i].getId();
+        MIntArray visibleIndexes;
+        status = MVGMayaUtil::getIntArrayAttribute(cameras[i].getDagPath().node(), _MVG_ITEMS,
+                                                   visibleIndexes);
+        CHECK_RETURN_STATUS(status)
+        observationCameraIds.insert(observationCameraIds.end(), visibleIndexes.length(), cameraId);
+        for(unsigned int j = 0; j < visibleIndexes.length(); ++j)
+            observationPointIds.push_back(visibleIndexes[j]);
+    }
+    _visibilityGraph.build(MVGPointCloud::getStore().size(), observationCameraIds,
+                           observationPointIds);
+    _visibilityGraphLoaded = true;
+    return status;
+}
+
+// static
+const MVGVisibilityGraph& MVGCamera::getVisibilityGraph()
+{
+    // a project without any observation has an empty graph: don't rebuild it on each call
+    if(!_visibilityGraphLoaded)
+        loadVisibilityGraph();
+    return _visibilityGraph;
+}
+
+/**
+ * Take ownership of an already built graph (the given one is left empty).
+ */
+// static
+void MVGCamera::setVisibilityGraph(MVGVisibilityGraph& visibilityGraph)
+{
+    _visibilityGraph.clear();
+    _visibilityGraph.swap(visibilityGraph);
+    _visibilityGraphLoaded = true;
+}
+
+// static
+void MVGCamera::clearVisibilityGraph()
+{
+    _visibilityGraph.clear();
+    _visibilityGraphLoaded = false;
+}
+
 int MVGCamera::getId() const
 {
     int id = -1;
@@ -277,17 +345,29 @@ void MVGCamera::getSensorSize(MIntArray& sensorSize) const
 
 void MVGCamera::getVisibleIndexes(MIntArray& visibleIndexes) const
 {
-    MStatus status;
-    status = MVGMayaUtil::getIntArrayAttribute(_dagpath.node(), _MVG_ITEMS, visibleIndexes);
-    CHECK(status)
+    const MVGVisibilityGraph::Range points = getVisiblePoints();
+    visibleIndexes.clear();
+    if(!points.empty())
+        visibleIndexes = MIntArray(points.begin(), points.size());
 }
 
-void MVGCamera::getVisibleItems(std::vector<MVGPointCloudItem>& visibleItems) const
+/**
+ * @return sorted ids of the points visible by this camera, valid until the graph is cleared
+ */
+MVGVisibilityGraph::Range MVGCamera::getVisiblePoints() const
 {
-    MIntArray visibleIndexes;
-    getVisibleIndexes(visibleIndexes);
-    MVGPointCloud pointCloud(MVGProject::_CLOUD);
-    pointCloud.getItems(visibleItems, visibleIndexes);
+    return getVisibilityGraph().getCameraPoints(getId());
+}
+
+void MVGCamera::getVisibleItems(std::vector<int>& visibleItems) const
+{
+    const MVGVisibilityGraph::Range points = getVisiblePoints();
+    const MVGPointCloudStore& store = MVGPointCloud::getStore();
+    // point ids are sorted, ids out of the store are at the end of the range
+    const int* last =
+        std::lower_bound(points.begin(), points.end(), static_cast<int>(store.size()));
+    const int* first = std::lower_bound(points.begin(), last, 0);
+    visibleItems.assign(first, last);
 }
 
 void MVGCamera::setVisibleItems(const std::vector<MVGPointCloudItem>& items) const
@@ -297,6 +377,8 @@ void MVGCamera::setVisibleItems(const std::vector<MVGPointCloudItem>& items) con
     for(size_t i = 0; i < items.size(); ++i)
         intArray.set(items[i]._id, i);
     MVGMayaUtil::setIntArrayAttribute(_dagpath.node(), _MVG_ITEMS, intArray);
+    // rebuilt from the attributes on next access
+    clearVisibilityGraph();
 }
 
 double MVGCamera::getZoom() const
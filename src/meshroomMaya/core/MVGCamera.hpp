@@ -1,9 +1,9 @@
 #pragma once
 
 #include "meshroomMaya/core/MVGNodeWrapper.hpp"
+#include "meshroomMaya/core/MVGVisibilityGraph.hpp"
 #include <maya/MColor.h>
 #include <vector>
-#include <map>
 
 class MString;
 class MPoint;
@@ -31,8 +31,12 @@ public:
     virtual bool isValid() const;
 
 public:
-    static MVGCamera create(MDagPath& cameraDagPath, std::map<int, MIntArray>& itemsPerCamera);
+    static MVGCamera create(MDagPath& cameraDagPath, const MVGVisibilityGraph& visibilityGraph);
     static std::vector<MVGCamera> getCameras();
+    static MStatus loadVisibilityGraph();
+    static const MVGVisibilityGraph& getVisibilityGraph();
+    static void setVisibilityGraph(MVGVisibilityGraph& visibilityGraph);
+    static void clearVisibilityGraph();
 
 public:
     int getId() const;
@@ -44,7 +48,8 @@ public:
     MPoint getCenter(MSpace::Space space = MSpace::kWorld) const;
     void getSensorSize(MIntArray& sensorSize) const;
     void getVisibleIndexes(MIntArray& visibleIndexes) const;
-    void getVisibleItems(std::vector<MVGPointCloudItem>& visibleItems) const;
+    MVGVisibilityGraph::Range getVisiblePoints() const;
+    void getVisibleItems(std::vector<int>& visibleItems) const;
     void setVisibleItems(const std::vector<MVGPointCloudItem>& item) const;
     double getZoom() const;
     void setZoom(const double zoom) const;
@@ -78,6 +83,9 @@ private:
     static MString _MVG_INTRINSIC_TYPE;
     static MString _MVG_INTRINSICS_PARAMS;
     static MString _MVG_SENSOR_SIZE;
+    /// camera/point visibility, built once per project load
+    static MVGVisibilityGraph _visibilityGraph;
+    static bool _visibilityGraphLoaded;
 };
 
 } // namespace
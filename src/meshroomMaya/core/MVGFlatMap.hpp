@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Associative container stored as a sorted vector of (key, value) pairs.
+ *
+ * Meant for the small per element maps (e.g. blind data per camera): one contiguous allocation
+ * instead of one heap node per entry. Provides the subset of the std::map interface in use.
+ * Inserting or erasing invalidates iterators.
+ */
+template <typename Key, typename Value>
+class MVGFlatMap
+{
+
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef std::pair<Key, Value> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+public:
+    iterator begin() { return _data.begin(); }
+    iterator end() { return _data.end(); }
+    const_iterator begin() const { return _data.begin(); }
+    const_iterator end() const { return _data.end(); }
+    size_t size() const { return _data.size(); }
+    bool empty() const { return _data.empty(); }
+    void clear() { _data.clear(); }
+    void reserve(const size_t count) { _data.reserve(count); }
+
+    iterator find(const Key& key)
+    {
+        iterator it = lowerBound(key);
+        return (it != _data.end() && it->first == key) ? it : _data.end();
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        const_iterator it = lowerBound(key);
+        return (it != _data.end() && it->first == key) ? it : _data.end();
+    }
+
+    size_t count(const Key& key) const { return find(key) != end() ? 1 : 0; }
+
+    Value& operator[](const Key& key)
+    {
+        iterator it = lowerBound(key);
+        if(it == _data.end() || it->first != key)
+            it = _data.insert(it, value_type(key, Value()));
+        return it->second;
+    }
+
+    const Value& at(const Key& key) const
+    {
+        const_iterator it = find(key);
+        if(it == _data.end())
+            throw std::out_of_range("MVGFlatMap::at");
+        return it->second;
+    }
+
+    size_t erase(const Key& key)
+    {
+        iterator it = find(key);
+        if(it == _data.end())
+            return 0;
+        _data.erase(it);
+        return 1;
+    }
+
+private:
+    static bool keyLess(const value_type& element, const Key& key) { return element.first < key; }
+    iterator lowerBound(const Key& key)
+    {
+        return std::lower_bound(_data.begin(), _data.end(), key, keyLess);
+    }
+    const_iterator lowerBound(const Key& key) const
+    {
+        return std::lower_bound(_data.begin(), _data.end(), key, keyLess);
+    }
+
+private:
+    std::vector<value_type> _data;
+};
+
+} // namespace
@@ -2,38 +2,73 @@
 #include "meshroomMaya/core/MVGPointCloud.hpp"
 #include "meshroomMaya/core/MVGProject.hpp"
 #include "meshroomMaya/core/MVGCamera.hpp"
+#include "meshroomMaya/core/MVGProjectionCache.hpp"
 #include "meshroomMaya/core/MVGLog.hpp"
 #include "meshroomMaya/core/MVGPlaneKernel.hpp"
 #include "meshroomMaya/core/MVGLineConstrainedPlaneKernel.hpp"
 #include "meshroomMaya/maya/MVGMayaUtil.hpp"
-#include <aliceVision/multiview/triangulation/Triangulation.hpp>
-#include <aliceVision/multiview/projection.hpp>
 #include <aliceVision/robustEstimation/leastMedianOfSquares.hpp>
 #include <maya/MPointArray.h>
 #include <maya/M3dView.h>
 #include <maya/MPlug.h>
 #include <maya/MFnDagNode.h>
 #include <maya/MMatrix.h>
+#include <maya/MFnCamera.h>
 
 namespace meshroomMaya
 {
 
-void MVGGeometryUtil::viewToCameraSpace(M3dView& view, const MPoint& viewPoint, MPoint& cameraPoint)
+MVGPlaneEstimatorOptions MVGGeometryUtil::_planeEstimatorOptions;
+
+MVGGeometryUtil::ViewTransform::ViewTransform()
+    : portWidth(0.0)
+    , portHeight(0.0)
+    , viewportWidth(0)
+    , viewportHeight(0)
+    , zoom(1.0)
+    , horizontalPan(0.0)
+    , verticalPan(0.0)
+    , horizontalFilmAperture(1.0)
+{
+}
+
+MVGGeometryUtil::ViewTransform::ViewTransform(M3dView& view)
 {
-    double portHeight = (double)view.portHeight();
-    double portWidth = (double)view.portWidth();
+    MStatus status;
+    portWidth = (double)view.portWidth();
+    portHeight = (double)view.portHeight();
+    unsigned int viewportX, viewportY;
+    view.viewport(viewportX, viewportY, viewportWidth, viewportHeight);
+    // camera parameters, retrieved with a single function set
     MDagPath dagPath;
     view.getCamera(dagPath);
     MVGCamera camera(dagPath);
-    // center
-    cameraPoint.x = (viewPoint.x / portWidth) - 0.5;
-    cameraPoint.y = (viewPoint.y / portWidth) - 0.5 - 0.5 * (portHeight / portWidth - 1.0);
-    cameraPoint.z = 0.;
-    // zoom
-    cameraPoint = cameraPoint * camera.getHorizontalFilmAperture() * camera.getZoom();
-    // pan
-    cameraPoint.x += camera.getHorizontalPan();
-    cameraPoint.y += camera.getVerticalPan();
+    MFnCamera fnCamera(camera.getDagPath(), &status);
+    CHECK(status)
+    zoom = fnCamera.zoom();
+    horizontalPan = fnCamera.horizontalPan();
+    verticalPan = fnCamera.verticalPan();
+    horizontalFilmAperture = fnCamera.horizontalFilmAperture();
+    // don't use M3dView::worldToView() because of the cast to short values
+    MMatrix modelViewMatrix, projectionMatrix;
+    CHECK(view.modelViewMatrix(modelViewMatrix))
+    CHECK(view.projectionMatrix(projectionMatrix))
+    viewProjectionMatrix = modelViewMatrix * projectionMatrix;
+}
+
+bool MVGGeometryUtil::ViewTransform::operator==(const ViewTransform& other) const
+{
+    return portWidth == other.portWidth && portHeight == other.portHeight &&
+           viewportWidth == other.viewportWidth && viewportHeight == other.viewportHeight &&
+           zoom == other.zoom && horizontalPan == other.horizontalPan &&
+           verticalPan == other.verticalPan &&
+           horizontalFilmAperture == other.horizontalFilmAperture &&
+           viewProjectionMatrix == other.viewProjectionMatrix;
+}
+
+void MVGGeometryUtil::viewToCameraSpace(M3dView& view, const MPoint& viewPoint, MPoint& cameraPoint)
+{
+    viewToCameraSpace(ViewTransform(view), viewPoint, cameraPoint);
 }
 
 MPoint MVGGeometryUtil::viewToCameraSpace(M3dView& view, const MPoint& viewPoint)
@@ -46,9 +81,7 @@ MPoint MVGGeometryUtil::viewToCameraSpace(M3dView& view, const MPoint& viewPoint
 void MVGGeometryUtil::viewToCameraSpace(M3dView& view, const MPointArray& viewPoints,
                                         MPointArray& cameraPoints)
 {
-    cameraPoints.setLength(viewPoints.length());
-    for(size_t i = 0; i < viewPoints.length(); ++i)
-        viewToCameraSpace(view, viewPoints[i], cameraPoints[i]);
+    viewToCameraSpace(ViewTransform(view), viewPoints, cameraPoints);
 }
 
 MPointArray MVGGeometryUtil::viewToCameraSpace(M3dView& view, const MPointArray& viewPoints)
@@ -60,21 +93,7 @@ MPointArray MVGGeometryUtil::viewToCameraSpace(M3dView& view, const MPointArray&
 
 void MVGGeometryUtil::cameraToViewSpace(M3dView& view, const MPoint& cameraPoint, MPoint& viewPoint)
 {
-    MDagPath dagPath;
-    view.getCamera(dagPath);
-    MVGCamera camera(dagPath);
-    float x = cameraPoint.x;
-    float y = cameraPoint.y;
-    // pan
-    x -= camera.getHorizontalPan();
-    y -= camera.getVerticalPan();
-    // zoom
-    x /= (camera.getHorizontalFilmAperture() * camera.getZoom());
-    y /= (camera.getHorizontalFilmAperture() * camera.getZoom());
-    // center
-    viewPoint.x = round((x + 0.5) * view.portWidth());
-    viewPoint.y = round((y + 0.5 + 0.5 * (view.portHeight() / (float)view.portWidth() - 1.0)) *
-                        view.portWidth());
+    cameraToViewSpace(ViewTransform(view), cameraPoint, viewPoint);
 }
 
 MPoint MVGGeometryUtil::cameraToViewSpace(M3dView& view, const MPoint& cameraPoint)
@@ -87,9 +106,7 @@ MPoint MVGGeometryUtil::cameraToViewSpace(M3dView& view, const MPoint& cameraPoi
 void MVGGeometryUtil::cameraToViewSpace(M3dView& view, const MPointArray& cameraPoints,
                                         MPointArray& viewPoints)
 {
-    viewPoints.setLength(cameraPoints.length());
-    for(size_t i = 0; i < viewPoints.length(); ++i)
-        cameraToViewSpace(view, cameraPoints[i], viewPoints[i]);
+    cameraToViewSpace(ViewTransform(view), cameraPoints, viewPoints);
 }
 
 MPointArray MVGGeometryUtil::cameraToViewSpace(M3dView& view, const MPointArray& cameraPoints)
@@ -101,18 +118,7 @@ MPointArray MVGGeometryUtil::cameraToViewSpace(M3dView& view, const MPointArray&
 
 void MVGGeometryUtil::worldToViewSpace(M3dView& view, const MPoint& worldPoint, MPoint& viewPoint)
 {
-    // don't use M3dView::worldToView() because of the cast to short values
-    MMatrix modelViewMatrix, projectionMatrix;
-    CHECK(view.modelViewMatrix(modelViewMatrix))
-    CHECK(view.projectionMatrix(projectionMatrix))
-    MPoint point = worldPoint * (modelViewMatrix * projectionMatrix);
-    unsigned int viewportX, viewportY, viewportWidth, viewportHeight;
-    view.viewport(viewportX, viewportY, viewportWidth, viewportHeight);
-    viewPoint.x =
-        static_cast<int>(static_cast<double>(viewportWidth) * (point.x / point.w + 1.0) / 2.0);
-    viewPoint.y =
-        static_cast<int>(static_cast<double>(viewportHeight) * (point.y / point.w + 1.0) / 2.0);
-    viewPoint.z = 0.0;
+    worldToViewSpace(ViewTransform(view), worldPoint, viewPoint);
 }
 
 MPoint MVGGeometryUtil::worldToViewSpace(M3dView& view, const MPoint& worldPoint)
@@ -125,9 +131,7 @@ MPoint MVGGeometryUtil::worldToViewSpace(M3dView& view, const MPoint& worldPoint
 void MVGGeometryUtil::worldToViewSpace(M3dView& view, const MPointArray& worldPoints,
                                        MPointArray& viewPoints)
 {
-    viewPoints.setLength(worldPoints.length());
-    for(size_t i = 0; i < worldPoints.length(); ++i)
-        worldToViewSpace(view, worldPoints[i], viewPoints[i]);
+    worldToViewSpace(ViewTransform(view), worldPoints, viewPoints);
 }
 
 MPointArray MVGGeometryUtil::worldToViewSpace(M3dView& view, const MPointArray& worldPoints)
@@ -170,28 +174,202 @@ MPointArray MVGGeometryUtil::viewToWorldSpace(M3dView& view, const MPointArray&
 void MVGGeometryUtil::worldToCameraSpace(M3dView& view, const MPoint& worldPoint,
                                          MPoint& cameraPoint)
 {
-    viewToCameraSpace(view, worldToViewSpace(view, worldPoint), cameraPoint);
+    worldToCameraSpace(ViewTransform(view), worldPoint, cameraPoint);
 }
 
 MPoint MVGGeometryUtil::worldToCameraSpace(M3dView& view, const MPoint& worldPoint)
 {
     MPoint point;
-    viewToCameraSpace(view, worldToViewSpace(view, worldPoint), point);
+    worldToCameraSpace(view, worldPoint, point);
     return point;
 }
 
 void MVGGeometryUtil::worldToCameraSpace(M3dView& view, const MPointArray& worldPoints,
                                          MPointArray& cameraPoints)
+{
+    worldToCameraSpace(ViewTransform(view), worldPoints, cameraPoints);
+}
+
+MPointArray MVGGeometryUtil::worldToCameraSpace(M3dView& view, const MPointArray& worldPoints)
+{
+    MPointArray points;
+    worldToCameraSpace(view, worldPoints, points);
+    return points;
+}
+
+void MVGGeometryUtil::viewToCameraSpace(const ViewTransform& transform, const MPoint& viewPoint,
+                                        MPoint& cameraPoint)
+{
+    // center
+    cameraPoint.x = (viewPoint.x / transform.portWidth) - 0.5;
+    cameraPoint.y = (viewPoint.y / transform.portWidth) - 0.5 -
+                    0.5 * (transform.portHeight / transform.portWidth - 1.0);
+    cameraPoint.z = 0.;
+    // zoom
+    cameraPoint = cameraPoint * transform.horizontalFilmAperture * transform.zoom;
+    // pan
+    cameraPoint.x += transform.horizontalPan;
+    cameraPoint.y += transform.verticalPan;
+}
+
+MPoint MVGGeometryUtil::viewToCameraSpace(const ViewTransform& transform, const MPoint& viewPoint)
+{
+    MPoint point;
+    viewToCameraSpace(transform, viewPoint, point);
+    return point;
+}
+
+void MVGGeometryUtil::viewToCameraSpace(const ViewTransform& transform,
+                                        const MPointArray& viewPoints, MPointArray& cameraPoints)
+{
+    cameraPoints.setLength(viewPoints.length());
+    for(size_t i = 0; i < viewPoints.length(); ++i)
+        viewToCameraSpace(transform, viewPoints[i], cameraPoints[i]);
+}
+
+MPointArray MVGGeometryUtil::viewToCameraSpace(const ViewTransform& transform,
+                                               const MPointArray& viewPoints)
+{
+    MPointArray points;
+    viewToCameraSpace(transform, viewPoints, points);
+    return points;
+}
+
+void MVGGeometryUtil::cameraToViewSpace(const ViewTransform& transform, const MPoint& cameraPoint,
+                                        MPoint& viewPoint)
+{
+    float x = cameraPoint.x;
+    float y = cameraPoint.y;
+    // pan
+    x -= transform.horizontalPan;
+    y -= transform.verticalPan;
+    // zoom
+    x /= (transform.horizontalFilmAperture * transform.zoom);
+    y /= (transform.horizontalFilmAperture * transform.zoom);
+    // center
+    viewPoint.x = round((x + 0.5) * transform.portWidth);
+    viewPoint.y = round(
+        (y + 0.5 + 0.5 * (transform.portHeight / (float)transform.portWidth - 1.0)) *
+        transform.portWidth);
+}
+
+MPoint MVGGeometryUtil::cameraToViewSpace(const ViewTransform& transform, const MPoint& cameraPoint)
+{
+    MPoint point;
+    cameraToViewSpace(transform, cameraPoint, point);
+    return point;
+}
+
+void MVGGeometryUtil::cameraToViewSpace(const ViewTransform& transform,
+                                        const MPointArray& cameraPoints, MPointArray& viewPoints)
+{
+    viewPoints.setLength(cameraPoints.length());
+    for(size_t i = 0; i < viewPoints.length(); ++i)
+        cameraToViewSpace(transform, cameraPoints[i], viewPoints[i]);
+}
+
+MPointArray MVGGeometryUtil::cameraToViewSpace(const ViewTransform& transform,
+                                               const MPointArray& cameraPoints)
+{
+    MPointArray points;
+    cameraToViewSpace(transform, cameraPoints, points);
+    return points;
+}
+
+void MVGGeometryUtil::worldToViewSpace(const ViewTransform& transform, const MPoint& worldPoint,
+                                       MPoint& viewPoint)
+{
+    const MPoint point = worldPoint * transform.viewProjectionMatrix;
+    viewPoint.x = static_cast<int>(static_cast<double>(transform.viewportWidth) *
+                                   (point.x / point.w + 1.0) / 2.0);
+    viewPoint.y = static_cast<int>(static_cast<double>(transform.viewportHeight) *
+                                   (point.y / point.w + 1.0) / 2.0);
+    viewPoint.z = 0.0;
+}
+
+MPoint MVGGeometryUtil::worldToViewSpace(const ViewTransform& transform, const MPoint& worldPoint)
+{
+    MPoint point;
+    worldToViewSpace(transform, worldPoint, point);
+    return point;
+}
+
+void MVGGeometryUtil::worldToViewSpace(const ViewTransform& transform,
+                                       const MPointArray& worldPoints, MPointArray& viewPoints)
+{
+    viewPoints.setLength(worldPoints.length());
+    for(size_t i = 0; i < worldPoints.length(); ++i)
+        worldToViewSpace(transform, worldPoints[i], viewPoints[i]);
+}
+
+MPointArray MVGGeometryUtil::worldToViewSpace(const ViewTransform& transform,
+                                              const MPointArray& worldPoints)
+{
+    MPointArray points;
+    worldToViewSpace(transform, worldPoints, points);
+    return points;
+}
+
+/**
+ * @brief Project points stored as separate coordinate arrays (see MVGPointCloudStore).
+ *
+ * @param[in] transform view snapshot
+ * @param[in] worldX, worldY, worldZ world space coordinate arrays
+ * @param[in] indexes indexes of the points to project in the coordinate arrays, NULL to project
+ * the first count points
+ * @param[in] count number of points to project
+ * @param[out] viewX, viewY view space coordinates, count values each
+ */
+void MVGGeometryUtil::worldToViewSpace(const ViewTransform& transform, const double* worldX,
+                                       const double* worldY, const double* worldZ,
+                                       const int* indexes, const size_t count, double* viewX,
+                                       double* viewY)
+{
+    const MMatrix& m = transform.viewProjectionMatrix;
+    const double m00 = m[0][0], m10 = m[1][0], m20 = m[2][0], m30 = m[3][0];
+    const double m01 = m[0][1], m11 = m[1][1], m21 = m[2][1], m31 = m[3][1];
+    const double m03 = m[0][3], m13 = m[1][3], m23 = m[2][3], m33 = m[3][3];
+    const double halfWidth = static_cast<double>(transform.viewportWidth) / 2.0;
+    const double halfHeight = static_cast<double>(transform.viewportHeight) / 2.0;
+    for(size_t i = 0; i < count; ++i)
+    {
+        const size_t index = indexes ? indexes[i] : i;
+        const double x = worldX[index];
+        const double y = worldY[index];
+        const double z = worldZ[index];
+        const double w = x * m03 + y * m13 + z * m23 + m33;
+        viewX[i] = static_cast<int>(halfWidth * ((x * m00 + y * m10 + z * m20 + m30) / w + 1.0));
+        viewY[i] = static_cast<int>(halfHeight * ((x * m01 + y * m11 + z * m21 + m31) / w + 1.0));
+    }
+}
+
+void MVGGeometryUtil::worldToCameraSpace(const ViewTransform& transform, const MPoint& worldPoint,
+                                         MPoint& cameraPoint)
+{
+    viewToCameraSpace(transform, worldToViewSpace(transform, worldPoint), cameraPoint);
+}
+
+MPoint MVGGeometryUtil::worldToCameraSpace(const ViewTransform& transform,
+                                           const MPoint& worldPoint)
+{
+    MPoint point;
+    worldToCameraSpace(transform, worldPoint, point);
+    return point;
+}
+
+void MVGGeometryUtil::worldToCameraSpace(const ViewTransform& transform,
+                                         const MPointArray& worldPoints, MPointArray& cameraPoints)
 {
     cameraPoints.setLength(worldPoints.length());
     for(size_t i = 0; i < worldPoints.length(); ++i)
-        viewToCameraSpace(view, worldToViewSpace(view, worldPoints[i]), cameraPoints[i]);
+        worldToCameraSpace(transform, worldPoints[i], cameraPoints[i]);
 }
 
-MPointArray MVGGeometryUtil::worldToCameraSpace(M3dView& view, const MPointArray& worldPoints)
+MPointArray MVGGeometryUtil::worldToCameraSpace(const ViewTransform& transform,
+                                                const MPointArray& worldPoints)
 {
     MPointArray points;
-    viewToCameraSpace(view, worldToViewSpace(view, worldPoints), points);
+    worldToCameraSpace(transform, worldPoints, points);
     return points;
 }
 
@@ -265,9 +443,11 @@ MPointArray MVGGeometryUtil::cameraToImageSpace(MVGCamera& camera, const MPointA
  *
  * @param[in] pointsWS : all points used to compute plane in World Space coordinates
  * @param[out] model : computed plane
+ * @param[in] weights : quality of each point, used to order PROSAC samples (optional)
  * @return
  */
-bool MVGGeometryUtil::computePlane(const MPointArray& pointsWS, PlaneKernel::Model& model)
+bool MVGGeometryUtil::computePlane(const MPointArray& pointsWS, PlaneKernel::Model& model,
+                                   const std::vector<double>& weights)
 {
     if(pointsWS.length() < 3)
         return false;
@@ -276,6 +456,10 @@ bool MVGGeometryUtil::computePlane(const MPointArray& pointsWS, PlaneKernel::Mod
     for(size_t i = 0; i < pointsWS.length(); ++i)
         facePointsMat.col(i) = TO_VEC3(pointsWS[i]);
     PlaneKernel kernel(facePointsMat);
+    // LMedS when asked, or as a fallback if no consensus has been found
+    if(_planeEstimatorOptions.method != MVGPlaneEstimatorOptions::eMethodLMedS &&
+       robustPlane::estimate(kernel, _planeEstimatorOptions, weights, model))
+        return true;
     double outlierThreshold = std::numeric_limits<double>::infinity();
     aliceVision::robustEstimation::LeastMedianOfSquares(kernel, &model, &outlierThreshold);
 
@@ -287,11 +471,13 @@ bool MVGGeometryUtil::computePlane(const MPointArray& pointsWS, PlaneKernel::Mod
  * @param[in] pointsWS: all points used to compute plane in World Space coordinates
  * @param[in] constraintPoints : points describing the line constraint
  * @param[out] model : computed plane
+ * @param[in] weights : quality of each point, used to order PROSAC samples (optional)
  * @return
  */
 bool MVGGeometryUtil::computePlaneWithLineConstraint(const MPointArray& pointsWS,
                                                      const MPointArray& constraintPoints,
-                                                     LineConstrainedPlaneKernel::Model& model)
+                                                     LineConstrainedPlaneKernel::Model& model,
+                                                     const std::vector<double>& weights)
 {
     if(pointsWS.length() < 3)
         return false;
@@ -300,8 +486,12 @@ bool MVGGeometryUtil::computePlaneWithLineConstraint(const MPointArray& pointsWS
     aliceVision::Mat facePointsMat(3, pointsWS.length());
     for(size_t i = 0; i < pointsWS.length(); ++i)
         facePointsMat.col(i) = TO_VEC3(pointsWS[i]);
-    LineConstrainedPlaneKernel kernel(facePointsMat, TO_VEC3(constraintPoints[0]),
-                                      TO_VEC3(constraintPoints[1]));
+    const aliceVision::Vec3 constraintP0 = TO_VEC3(constraintPoints[0]);
+    const aliceVision::Vec3 constraintP1 = TO_VEC3(constraintPoints[1]);
+    LineConstrainedPlaneKernel kernel(facePointsMat, constraintP0, constraintP1);
+    if(_planeEstimatorOptions.method != MVGPlaneEstimatorOptions::eMethodLMedS &&
+       robustPlane::estimate(kernel, _planeEstimatorOptions, weights, model))
+        return true;
     double outlierThreshold = std::numeric_limits<double>::infinity();
     aliceVision::robustEstimation::LeastMedianOfSquares(kernel, &model, &outlierThreshold);
 
@@ -328,11 +518,13 @@ bool MVGGeometryUtil::projectPointsOnPlane(M3dView& view, const MPointArray& toP
     MPoint cameraCenter = camera.getCenter();
 
     // project points on computed plane
+    const MPointArray toProjectVSPoints =
+        MVGGeometryUtil::cameraToViewSpace(ViewTransform(view), toProjectCSPoints);
     MPoint projectedWSPoint;
     for(size_t i = 0; i < toProjectCSPoints.length(); ++i)
     {
         plane_line_intersect(planeModel, cameraCenter,
-                             MVGGeometryUtil::cameraToWorldSpace(view, toProjectCSPoints[i]),
+                             MVGGeometryUtil::viewToWorldSpace(view, toProjectVSPoints[i]),
                              projectedWSPoint);
         projectedWSPoints.append(projectedWSPoint);
     }
@@ -357,16 +549,22 @@ bool MVGGeometryUtil::projectPointOnPlane(M3dView& view, const MPoint& toProject
 }
 
 /**
- * @brief N-View triangulation.
+ * @brief N-View triangulation, minimizing the reprojection error.
  *
  * @param point2dPerCamera_CS map of 2d points per camera in Camera Space
  * @param outTriangulatedPoint_WS 3D triangulated point in World Space
+ * @param triangulator optional triangulator kept between calls, starting from its previous result
+ * @param outResidualPerCamera optional reprojection error per camera, in pixels
+ * @return false if the point can't be triangulated
  */
-void MVGGeometryUtil::triangulatePoint(const std::map<int, MPoint>& point2dPerCamera_CS,
-                                       MPoint& outTriangulatedPoint_WS)
+bool MVGGeometryUtil::triangulatePoint(const std::map<int, MPoint>& point2dPerCamera_CS,
+                                       MPoint& outTriangulatedPoint_WS,
+                                       MVGPointTriangulator* triangulator,
+                                       std::map<int, double>* outResidualPerCamera)
 {
     const size_t cameraCount = point2dPerCamera_CS.size();
-    assert(cameraCount > 1);
+    if(cameraCount < 2)
+        return false;
     // prepare n-view triangulation data
     aliceVision::Mat2X imagePoints(2, cameraCount);
 
@@ -375,73 +573,42 @@ void MVGGeometryUtil::triangulatePoint(const std::map<int, MPoint>& point2dPerCa
         std::map<int, MPoint>::const_iterator it = point2dPerCamera_CS.begin();
         for(size_t i = 0; it != point2dPerCamera_CS.end(); ++i, ++it)
         {
-            MVGCamera camera(it->first);
-            const MPoint& point2d_CS = it->second;
-
-            // Retrieve the intrinsic matrix from 'pinholeProjectionMatrix' attribute
-            //
-            // K Matrix:
-            // f*k_u     0      c_u
-            //   0     f*k_v    c_v
-            //   0       0       1
-            // c_u, c_v : the principal point, which would be ideally in the centre of the image.
-            //
-            MDoubleArray intrinsicsArray;
-            MVGMayaUtil::getDoubleArrayAttribute(camera.getDagPath().node(), "mvg_intrinsicParams",
-                                                 intrinsicsArray);
-            MIntArray sensorSize;
-            camera.getSensorSize(sensorSize);
-
-            // Keep ideal matrix with principal point centered
-            aliceVision::Mat3 K;
-            K << intrinsicsArray[0], 0.0, sensorSize[0] / 2.0, 0.0, intrinsicsArray[0],
-                sensorSize[1] / 2.0, 0.0, 0.0, 1.0;
-
-            // Retrieve transformation matrix
-            const MMatrix inclusiveMatrix = camera.getDagPath().inclusiveMatrix();
-            const MTransformationMatrix transformMatrix(inclusiveMatrix);
-            aliceVision::Mat3 R;
-            MMatrix rotationMatrix = transformMatrix.asRotateMatrix();
-            for(int m = 0; m < 3; ++m)
+            // projection matrix and image space parameters are cached per camera
+            const MVGProjectionCache::CameraProjection* projection =
+                MVGProjectionCache::getProjection(it->first);
+            if(!projection)
             {
-                for(int j = 0; j < 3; ++j)
-                {
-                    // Maya has inverted Y and Z axes
-                    int sign = 1;
-                    if(m > 0)
-                        sign = -1;
-                    R(m, j) = sign * rotationMatrix[m][j];
-                }
+                LOG_ERROR("Unable to retrieve projection for camera " << it->first)
+                return false;
             }
-
-            // Retrieve translation vector
-            const aliceVision::Vec3 C = TO_VEC3(camera.getCenter());
-            const aliceVision::Vec3 t = -R * C;
-
-            // Compute projection matrix
-            aliceVision::Mat34 P;
-            aliceVision::P_From_KRt(K, R, t, &P);
-            projectiveCameras.push_back(P);
+            projectiveCameras.push_back(projection->P);
 
             // clicked point matrix (image space)
-            MPoint clickedISPosition;
-            MVGGeometryUtil::cameraToImageSpace(camera, point2d_CS, clickedISPosition);
-            imagePoints.col(i) = aliceVision::Vec2(clickedISPosition.x, clickedISPosition.y);
+            imagePoints.col(i) = projection->cameraToImageSpace(it->second);
         }
     }
 
     // call n-view triangulation function
-    aliceVision::Vec4 result;
-    aliceVision::TriangulateNViewAlgebraic(imagePoints, projectiveCameras, &result);
-    outTriangulatedPoint_WS.x = result(0);
-    outTriangulatedPoint_WS.y = result(1);
-    outTriangulatedPoint_WS.z = result(2);
-    if(result(3) == 0.0)
+    MVGPointTriangulator localTriangulator;
+    if(!triangulator)
+        triangulator = &localTriangulator;
+    aliceVision::Vec3 result;
+    std::vector<double> residuals;
+    if(!triangulator->triangulate(projectiveCameras, imagePoints, result,
+                                  outResidualPerCamera ? &residuals : NULL))
     {
         LOG_ERROR("Triangulated point w = 0")
-        return;
+        return false;
+    }
+    outTriangulatedPoint_WS = MPoint(result(0), result(1), result(2));
+    if(outResidualPerCamera)
+    {
+        outResidualPerCamera->clear();
+        std::map<int, MPoint>::const_iterator it = point2dPerCamera_CS.begin();
+        for(size_t i = 0; it != point2dPerCamera_CS.end(); ++i, ++it)
+            (*outResidualPerCamera)[it->first] = residuals[i];
     }
-    outTriangulatedPoint_WS = outTriangulatedPoint_WS / result(3);
+    return true;
 }
 
 double MVGGeometryUtil::crossProduct2D(MVector& A, MVector& B)
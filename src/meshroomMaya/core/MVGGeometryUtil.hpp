@@ -2,10 +2,14 @@
 
 #include "meshroomMaya/core/MVGPlaneKernel.hpp"
 #include "meshroomMaya/core/MVGLineConstrainedPlaneKernel.hpp"
+#include "meshroomMaya/core/MVGPlaneEstimator.hpp"
+#include "meshroomMaya/core/MVGPointTriangulator.hpp"
 
 #include <maya/MVector.h>
+#include <maya/MMatrix.h>
 
 #include <map>
+#include <vector>
 
 
 class MPoint;
@@ -22,6 +26,30 @@ class MVGCamera;
 
 struct MVGGeometryUtil
 {
+    /**
+     * @brief Snapshot of the view parameters used by the space conversions.
+     *
+     * Querying the camera and the view matrices is costly: take one snapshot per event and use
+     * the ViewTransform overloads to convert points, instead of the M3dView ones.
+     */
+    struct ViewTransform
+    {
+        ViewTransform();
+        explicit ViewTransform(M3dView& view);
+        bool operator==(const ViewTransform& other) const;
+        bool operator!=(const ViewTransform& other) const { return !(*this == other); }
+
+        double portWidth;
+        double portHeight;
+        unsigned int viewportWidth;
+        unsigned int viewportHeight;
+        double zoom;
+        double horizontalPan;
+        double verticalPan;
+        double horizontalFilmAperture;
+        MMatrix viewProjectionMatrix; // modelView * projection
+    };
+
     // space conversion
     static void viewToCameraSpace(M3dView& view, const MPoint& viewPoint, MPoint& cameraPoint);
     static MPoint viewToCameraSpace(M3dView& view, const MPoint& viewPoint);
@@ -59,6 +87,41 @@ struct MVGGeometryUtil
                                    MPointArray& worldPoints);
     static MPointArray cameraToWorldSpace(M3dView& view, const MPointArray& cameraPoints);
 
+    static void viewToCameraSpace(const ViewTransform& transform, const MPoint& viewPoint,
+                                  MPoint& cameraPoint);
+    static MPoint viewToCameraSpace(const ViewTransform& transform, const MPoint& viewPoint);
+    static void viewToCameraSpace(const ViewTransform& transform, const MPointArray& viewPoints,
+                                  MPointArray& cameraPoints);
+    static MPointArray viewToCameraSpace(const ViewTransform& transform,
+                                         const MPointArray& viewPoints);
+
+    static void cameraToViewSpace(const ViewTransform& transform, const MPoint& cameraPoint,
+                                  MPoint& viewPoint);
+    static MPoint cameraToViewSpace(const ViewTransform& transform, const MPoint& cameraPoint);
+    static void cameraToViewSpace(const ViewTransform& transform, const MPointArray& cameraPoints,
+                                  MPointArray& viewPoints);
+    static MPointArray cameraToViewSpace(const ViewTransform& transform,
+                                         const MPointArray& cameraPoints);
+
+    static void worldToViewSpace(const ViewTransform& transform, const MPoint& worldPoint,
+                                 MPoint& viewPoint);
+    static MPoint worldToViewSpace(const ViewTransform& transform, const MPoint& worldPoint);
+    static void worldToViewSpace(const ViewTransform& transform, const MPointArray& worldPoints,
+                                 MPointArray& viewPoints);
+    static MPointArray worldToViewSpace(const ViewTransform& transform,
+                                        const MPointArray& worldPoints);
+    static void worldToViewSpace(const ViewTransform& transform, const double* worldX,
+                                 const double* worldY, const double* worldZ, const int* indexes,
+                                 const size_t count, double* viewX, double* viewY);
+
+    static void worldToCameraSpace(const ViewTransform& transform, const MPoint& worldPoint,
+                                   MPoint& cameraPoint);
+    static MPoint worldToCameraSpace(const ViewTransform& transform, const MPoint& worldPoint);
+    static void worldToCameraSpace(const ViewTransform& transform, const MPointArray& worldPoints,
+                                   MPointArray& cameraPoints);
+    static MPointArray worldToCameraSpace(const ViewTransform& transform,
+                                          const MPointArray& worldPoints);
+
     static void cameraToImageSpace(MVGCamera& camera, const MPoint& cameraPoint,
                                    MPoint& imagePoint);
     static MPoint cameraToImageSpace(MVGCamera& camera, const MPoint& cameraPoint);
@@ -67,10 +130,14 @@ struct MVGGeometryUtil
     static MPointArray cameraToImageSpace(MVGCamera& camera, const MPointArray& cameraPoint);
 
     // projections
-    static bool computePlane(const MPointArray& points, PlaneKernel::Model& model);
-    static bool computePlaneWithLineConstraint(const MPointArray& pointsWS,
-                                               const MPointArray& constraintPoints,
-                                               LineConstrainedPlaneKernel::Model& model);
+    /// robust estimator used by computePlane and computePlaneWithLineConstraint
+    static MVGPlaneEstimatorOptions _planeEstimatorOptions;
+    static bool computePlane(const MPointArray& points, PlaneKernel::Model& model,
+                             const std::vector<double>& weights = std::vector<double>());
+    static bool computePlaneWithLineConstraint(
+        const MPointArray& pointsWS, const MPointArray& constraintPoints,
+        LineConstrainedPlaneKernel::Model& model,
+        const std::vector<double>& weights = std::vector<double>());
     static bool projectPointsOnPlane(M3dView& view, const MPointArray& toProjectCSPoints,
                                      const PlaneKernel::Model& planeModel,
                                      MPointArray& projectedWSPoints);
@@ -78,8 +145,10 @@ struct MVGGeometryUtil
                                     const PlaneKernel::Model& planeModel, MPoint& projectedWSPoint);
 
     // triangulation
-    static void triangulatePoint(const std::map<int, MPoint>& point2dPerCamera_CS,
-                                 MPoint& outTriangulatedPoint_WS);
+    static bool triangulatePoint(const std::map<int, MPoint>& point2dPerCamera_CS,
+                                 MPoint& outTriangulatedPoint_WS,
+                                 MVGPointTriangulator* triangulator = NULL,
+                                 std::map<int, double>* outResidualPerCamera = NULL);
 
     // intersections
     static double crossProduct2D(MVector& A, MVector& B);
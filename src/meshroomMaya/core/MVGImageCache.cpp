@@ -0,0 +1,121 @@
+#include "meshroomMaya/core/MVGImageCache.hpp"
+
+namespace meshroomMaya
+{
+
+MVGImageCache::MVGImageCache(const size_t budget)
+    : _budget(budget)
+    , _usedBytes(0)
+    , _hits(0)
+    , _misses(0)
+    , _evictions(0)
+{
+}
+
+/**
+ * @param[in] budget : maximum number of bytes used by the cached images
+ * @param[out] evicted : keys evicted to fit in the new budget
+ */
+void MVGImageCache::setBudget(const size_t budget, std::vector<std::string>& evicted)
+{
+    _budget = budget;
+    evict(evicted);
+}
+
+std::vector<std::string> MVGImageCache::getKeys() const
+{
+    std::vector<std::string> keys;
+    keys.reserve(_entries.size());
+    for(EntryList::const_reverse_iterator it = _entries.rbegin(); it != _entries.rend(); ++it)
+        keys.push_back(it->key);
+    return keys;
+}
+
+/**
+ * Mark an entry as the most recently used one.
+ * @return whether the key is in the cache (counted as a hit, a miss otherwise)
+ */
+bool MVGImageCache::touch(const std::string& key)
+{
+    std::unordered_map<std::string, EntryList::iterator>::iterator it = _positions.find(key);
+    if(it == _positions.end())
+    {
+        ++_misses;
+        return false;
+    }
+    ++_hits;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return true;
+}
+
+/**
+ * Insert (or touch) an entry as the most recently used one, then evict the least recently used
+ * entries until the cache fits in its budget. An entry bigger than the whole budget is evicted
+ * right away.
+ * @param[in] key : camera name
+ * @param[in] bytes : estimated memory used by the image
+ * @param[out] evicted : keys evicted from the cache
+ * @param[in] leastRecentlyUsed : insert the entry as the least recently used one instead, so that
+ * it does not evict entries that have been used (prefetched images)
+ */
+void MVGImageCache::insert(const std::string& key, const size_t bytes,
+                           std::vector<std::string>& evicted, const bool leastRecentlyUsed)
+{
+    const EntryList::iterator position = leastRecentlyUsed ? _entries.end() : _entries.begin();
+    std::unordered_map<std::string, EntryList::iterator>::iterator it = _positions.find(key);
+    if(it != _positions.end())
+    {
+        _usedBytes -= it->second->bytes;
+        it->second->bytes = bytes;
+        _entries.splice(position, _entries, it->second);
+    }
+    else
+    {
+        Entry entry;
+        entry.key = key;
+        entry.bytes = bytes;
+        _positions[key] = _entries.insert(position, entry);
+    }
+    _usedBytes += bytes;
+    evict(evicted);
+}
+
+bool MVGImageCache::remove(const std::string& key)
+{
+    std::unordered_map<std::string, EntryList::iterator>::iterator it = _positions.find(key);
+    if(it == _positions.end())
+        return false;
+    _usedBytes -= it->second->bytes;
+    _entries.erase(it->second);
+    _positions.erase(it);
+    return true;
+}
+
+void MVGImageCache::clear()
+{
+    _entries.clear();
+    _positions.clear();
+    _usedBytes = 0;
+}
+
+void MVGImageCache::resetCounters()
+{
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+void MVGImageCache::evict(std::vector<std::string>& evicted)
+{
+    while(_usedBytes > _budget && !_entries.empty())
+    {
+        const Entry& entry = _entries.back();
+        evicted.push_back(entry.key);
+        _usedBytes -= entry.bytes;
+        _positions.erase(entry.key);
+        _entries.pop_back();
+        ++_evictions;
+    }
+}
+
+} // namespace
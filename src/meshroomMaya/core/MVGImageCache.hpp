@@ -0,0 +1,70 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Least recently used set of loaded images, bounded by a memory budget.
+ *
+ * Entries are keyed by camera name and weighted by the estimated size of their image in bytes.
+ * Touching, inserting and removing an entry are constant time operations.
+ * The cache only does the bookkeeping: evicted keys are returned to the caller, which is in
+ * charge of unloading the corresponding images. This class does not depend on Maya.
+ */
+class MVGImageCache
+{
+
+public:
+    MVGImageCache(const size_t budget = 0);
+
+public:
+    void setBudget(const size_t budget, std::vector<std::string>& evicted);
+    size_t getBudget() const { return _budget; }
+    size_t getUsedBytes() const { return _usedBytes; }
+    size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+    bool contains(const std::string& key) const { return _positions.count(key) > 0; }
+    /// keys from the least to the most recently used
+    std::vector<std::string> getKeys() const;
+
+public:
+    bool touch(const std::string& key);
+    void insert(const std::string& key, const size_t bytes, std::vector<std::string>& evicted,
+                const bool leastRecentlyUsed = false);
+    bool remove(const std::string& key);
+    void clear();
+
+public:
+    size_t getHits() const { return _hits; }
+    size_t getMisses() const { return _misses; }
+    size_t getEvictions() const { return _evictions; }
+    void resetCounters();
+
+private:
+    void evict(std::vector<std::string>& evicted);
+
+private:
+    struct Entry
+    {
+        std::string key;
+        size_t bytes;
+    };
+    typedef std::list<Entry> EntryList;
+
+    /// entries from the most to the least recently used
+    EntryList _entries;
+    std::unordered_map<std::string, EntryList::iterator> _positions;
+    size_t _budget;
+    size_t _usedBytes;
+    size_t _hits;
+    size_t _misses;
+    size_t _evictions;
+};
+
+} // namespace
@@ -0,0 +1,157 @@
+#include "meshroomMaya/core/MVGIncrementalPlaneFitter.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace meshroomMaya
+{
+
+const double MVGIncrementalPlaneFitter::DEFAULT_MAX_RESIDUAL_RATIO = 0.05;
+
+MVGIncrementalPlaneFitter::MVGIncrementalPlaneFitter()
+    : _store(NULL)
+    , _storeRevision(0)
+    , _origin(aliceVision::Vec3::Zero())
+    , _sum(aliceVision::Vec3::Zero())
+    , _sumSquares(aliceVision::Mat3::Zero())
+    , _removedCount(0)
+    , _maxResidualRatio(DEFAULT_MAX_RESIDUAL_RATIO)
+{
+}
+
+void MVGIncrementalPlaneFitter::clear()
+{
+    _store = NULL;
+    _storeRevision = 0;
+    _items.clear();
+    _origin.setZero();
+    _sum.setZero();
+    _sumSquares.setZero();
+    _removedCount = 0;
+}
+
+/**
+ * Only the items entering or leaving the set are accumulated.
+ *
+ * @param[in] store : point cloud store the items refer to
+ * @param[in] items : sorted store indexes of the items
+ */
+void MVGIncrementalPlaneFitter::update(const MVGPointCloudStore& store,
+                                       const std::vector<int>& items)
+{
+    if(_store != &store || _storeRevision != store.getRevision())
+    {
+        clear();
+        _store = &store;
+        _storeRevision = store.getRevision();
+    }
+    _added.clear();
+    _removed.clear();
+    std::set_difference(items.begin(), items.end(), _items.begin(), _items.end(),
+                        std::back_inserter(_added));
+    std::set_difference(_items.begin(), _items.end(), items.begin(), items.end(),
+                        std::back_inserter(_removed));
+    if(_added.empty() && _removed.empty())
+        return;
+    _items = items;
+    // accumulate from scratch a set with no item in common, or once too many were removed
+    if(_added.size() == _items.size() || _removedCount + _removed.size() > _items.size())
+    {
+        rebuild();
+        return;
+    }
+    for(size_t i = 0; i < _removed.size(); ++i)
+        accumulate(_removed[i], -1.0);
+    for(size_t i = 0; i < _added.size(); ++i)
+        accumulate(_added[i], 1.0);
+    _removedCount += _removed.size();
+}
+
+/**
+ * @param[out] model : plane of least variance of the items
+ * @return false if there are not enough items, or if they are not planar enough
+ */
+bool MVGIncrementalPlaneFitter::fitPlane(PlaneKernel::Model& model) const
+{
+    if(_items.size() < PlaneKernel::MINIMUM_SAMPLES)
+        return false;
+    const double count = static_cast<double>(_items.size());
+    const aliceVision::Vec3 mean = _sum / count;
+    const aliceVision::Mat3 covariance = _sumSquares / count - mean * mean.transpose();
+    Eigen::SelfAdjointEigenSolver<aliceVision::Mat3> solver(covariance);
+    if(solver.info() != Eigen::Success)
+        return false;
+    // eigen values are sorted in increasing order
+    const aliceVision::Vec3& variances = solver.eigenvalues();
+    const double inPlaneVariance = variances(1) + variances(2);
+    if(variances(1) <= 0.0 ||
+       std::max(variances(0), 0.0) > _maxResidualRatio * _maxResidualRatio * inPlaneVariance)
+        return false;
+    const aliceVision::Vec3 normal = solver.eigenvectors().col(0);
+    model.head<3>() = normal;
+    model[3] = -1.0 * normal.dot(_origin + mean);
+    return true;
+}
+
+/**
+ * @param[in] constraintP0 : first point of the line the plane has to contain
+ * @param[in] constraintP1 : second point of the line the plane has to contain
+ * @param[out] model : plane of least variance of the items, containing the line
+ * @return false if there are not enough items, or if they are not planar enough
+ */
+bool MVGIncrementalPlaneFitter::fitPlaneWithLineConstraint(
+    const aliceVision::Vec3& constraintP0, const aliceVision::Vec3& constraintP1,
+    LineConstrainedPlaneKernel::Model& model) const
+{
+    const aliceVision::Vec3 line = constraintP1 - constraintP0;
+    if(_items.size() < 3 || line.squaredNorm() == 0.0)
+        return false;
+    // second order moments around the first line point
+    const double count = static_cast<double>(_items.size());
+    const aliceVision::Vec3 offset = constraintP0 - _origin;
+    const aliceVision::Mat3 moments = _sumSquares - offset * _sum.transpose() -
+                                      _sum * offset.transpose() +
+                                      count * offset * offset.transpose();
+    // normal in the (u, v) basis of the plane orthogonal to the line
+    const aliceVision::Vec3 direction = line.normalized();
+    const aliceVision::Vec3 u = direction.unitOrthogonal();
+    const aliceVision::Vec3 v = direction.cross(u);
+    Eigen::Matrix<double, 3, 2> basis;
+    basis << u, v;
+    const Eigen::Matrix2d projectedMoments = basis.transpose() * moments * basis;
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> solver(projectedMoments);
+    if(solver.info() != Eigen::Success)
+        return false;
+    const Eigen::Vector2d& variances = solver.eigenvalues();
+    if(variances(1) <= 0.0 ||
+       std::max(variances(0), 0.0) > _maxResidualRatio * _maxResidualRatio * variances(1))
+        return false;
+    const aliceVision::Vec3 normal = (basis * solver.eigenvectors().col(0)).normalized();
+    model.head<3>() = normal;
+    model[3] = -1.0 * normal.dot(constraintP0);
+    return true;
+}
+
+void MVGIncrementalPlaneFitter::accumulate(const int storeIndex, const double sign)
+{
+    const aliceVision::Vec3 point =
+        aliceVision::Vec3(_store->getX(storeIndex), _store->getY(storeIndex),
+                          _store->getZ(storeIndex)) -
+        _origin;
+    _sum += sign * point;
+    _sumSquares += sign * point * point.transpose();
+}
+
+void MVGIncrementalPlaneFitter::rebuild()
+{
+    _sum.setZero();
+    _sumSquares.setZero();
+    _removedCount = 0;
+    if(_items.empty())
+        return;
+    const int first = _items.front();
+    _origin = aliceVision::Vec3(_store->getX(first), _store->getY(first), _store->getZ(first));
+    for(size_t i = 0; i < _items.size(); ++i)
+        accumulate(_items[i], 1.0);
+}
+
+} // namespace
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "meshroomMaya/core/MVGPointCloudStore.hpp"
+#include "meshroomMaya/core/MVGPlaneKernel.hpp"
+#include "meshroomMaya/core/MVGLineConstrainedPlaneKernel.hpp"
+#include <vector>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Least-squares plane of a set of point cloud items, updated incrementally.
+ *
+ * Keeps the first and second order moments of the enclosed items, so that moving the enclosing
+ * polygon only costs the items entering or leaving it. The plane is the direction of least
+ * variance of the items (PCA). It is refused when the items are too far from being planar
+ * (outliers, several surfaces), the caller then falling back to a robust estimation.
+ * Moments are relative to the first added item to keep them accurate far from the origin, and
+ * accumulated again once as many items have been removed as there are left, to bound the
+ * drift of the subtractions.
+ */
+class MVGIncrementalPlaneFitter
+{
+
+public:
+    MVGIncrementalPlaneFitter();
+
+public:
+    void clear();
+    void update(const MVGPointCloudStore& store, const std::vector<int>& items);
+    bool fitPlane(PlaneKernel::Model& model) const;
+    bool fitPlaneWithLineConstraint(const aliceVision::Vec3& constraintP0,
+                                    const aliceVision::Vec3& constraintP1,
+                                    LineConstrainedPlaneKernel::Model& model) const;
+    size_t size() const { return _items.size(); }
+
+public:
+    /// residual deviation allowed to the plane, relative to the in-plane deviation of the items
+    static const double DEFAULT_MAX_RESIDUAL_RATIO;
+    double getMaxResidualRatio() const { return _maxResidualRatio; }
+    void setMaxResidualRatio(const double ratio) { _maxResidualRatio = ratio; }
+
+private:
+    void accumulate(const int storeIndex, const double sign);
+    void rebuild();
+
+private:
+    /// store and sorted store indexes of the items the moments are computed on
+    const MVGPointCloudStore* _store;
+    unsigned int _storeRevision;
+    std::vector<int> _items;
+    /// moments of the items, relative to _origin
+    aliceVision::Vec3 _origin;
+    aliceVision::Vec3 _sum;
+    aliceVision::Mat3 _sumSquares;
+    size_t _removedCount;
+    double _maxResidualRatio;
+    /// items entering and leaving the set on update, kept to avoid allocations
+    std::vector<int> _added;
+    std::vector<int> _removed;
+};
+
+} // namespace
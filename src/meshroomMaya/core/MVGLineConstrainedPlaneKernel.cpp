@@ -42,4 +42,31 @@ void LineConstrainedPlaneKernel::Fit(const std::vector<size_t>& samples, std::ve
     equation->push_back(m);
 }
 
+bool LineConstrainedPlaneKernel::Refit(const std::vector<size_t>& samples,
+                                       Model& equation) const
+{
+    if(samples.size() < MINIMUM_SAMPLES || _P1P0.squaredNorm() == 0.0)
+        return false;
+    // The normal is orthogonal to the line: search it in the (u, v) basis of the orthogonal
+    // plane, as the direction of least variance of the samples around the line
+    const aliceVision::Vec3 direction = _P1P0.normalized();
+    aliceVision::Vec3 u = direction.unitOrthogonal();
+    aliceVision::Vec3 v = direction.cross(u);
+    Eigen::Matrix2d moments = Eigen::Matrix2d::Zero();
+    for(size_t i = 0; i < samples.size(); ++i)
+    {
+        const aliceVision::Vec3 p2p0 = _pt.col(samples[i]) - _constraintP0;
+        const Eigen::Vector2d projected(p2p0.dot(u), p2p0.dot(v));
+        moments += projected * projected.transpose();
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> solver(moments);
+    if(solver.info() != Eigen::Success || solver.eigenvalues()(1) <= 0.0)
+        return false;
+    const Eigen::Vector2d normal2d = solver.eigenvectors().col(0);
+    const aliceVision::Vec3 normal = (normal2d(0) * u + normal2d(1) * v).normalized();
+    equation.head<3>() = normal;
+    equation[3] = -1.0 * normal.dot(_constraintP0);
+    return true;
+}
+
 } // namespace
@@ -18,6 +18,8 @@ struct LineConstrainedPlaneKernel
                                const aliceVision::Vec3& constraintP1);
     size_t NumSamples() const { return _pt.cols(); }
     void Fit(const std::vector<size_t>& samples, std::vector<Model>* equation) const;
+    /// Least-squares plane containing the constraint line, through the given samples
+    bool Refit(const std::vector<size_t>& samples, Model& equation) const;
     inline double Error(size_t sample, const Model& model) const
     {
         // Calculate the distance from the point to the plane normal as the dot
@@ -14,6 +14,8 @@
 #include <maya/MItDag.h>
 #include <maya/MGlobal.h>
 #include <maya/MPointArray.h>
+#include <maya/MStringArray.h>
+#include <maya/MIntArray.h>
 #include <maya/MFloatPointArray.h>
 #include <maya/MFnNumericAttribute.h>
 #include <maya/MPlug.h>
@@ -351,6 +353,21 @@ MStatus MVGMesh::setPoints(const MIntArray& verticesIds, const MPointArray& poin
     return status;
 }
 
+/**
+ * Replace the positions of all the vertices with a single MFnMesh::setPoints.
+ * @param[in] points : world space position of each vertex
+ */
+MStatus MVGMesh::setAllPoints(const MPointArray& points) const
+{
+    MStatus status;
+    MFnMesh fnMesh(_object, &status);
+    CHECK_RETURN_STATUS(status);
+    MPointArray pointArray(points);
+    status = fnMesh.setPoints(pointArray, MSpace::kWorld);
+    CHECK_RETURN_STATUS(status)
+    return status;
+}
+
 MStatus MVGMesh::getPoint(int vertexId, MPoint& point) const
 {
     MStatus status;
@@ -410,6 +427,41 @@ MStatus MVGMesh::getBlindData(const int vertexId,
     return status;
 }
 
+/**
+ * Read the blind data of all the vertices at once, instead of querying each vertex.
+ * @param[out] vertexIds : vertices having blind data
+ * @param[out] data : clicked positions of each of these vertices
+ */
+MStatus MVGMesh::getAllBlindData(std::vector<int>& vertexIds,
+                                 std::vector<std::vector<ClickedCSPosition> >& data) const
+{
+    vertexIds.clear();
+    data.clear();
+    MStatus status;
+    MFnMesh fnMesh(_object, &status);
+    CHECK_RETURN_STATUS(status);
+    if(!fnMesh.hasBlindData(MFn::kMeshVertComponent))
+        return status;
+    MIntArray componentIds;
+    MStringArray binaryData;
+    CHECK_RETURN_STATUS(fnMesh.getBinaryBlindData(MFn::kMeshVertComponent, _blindDataID, "data",
+                                                  componentIds, binaryData))
+    vertexIds.reserve(componentIds.length());
+    data.reserve(componentIds.length());
+    for(unsigned int i = 0; i < componentIds.length(); ++i)
+    {
+        int binarySize = 0;
+        const char* binData = binaryData[i].asChar(binarySize);
+        // cleared blind data is kept as an empty entry
+        if(binarySize < (int)sizeof(ClickedCSPosition))
+            continue;
+        vertexIds.push_back(componentIds[i]);
+        data.push_back(std::vector<ClickedCSPosition>());
+        binaryToVectorData(binData, binarySize, data.back());
+    }
+    return status;
+}
+
 MStatus MVGMesh::unsetAllBlindData() const
 {
     MStatus status;
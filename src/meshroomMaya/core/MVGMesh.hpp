@@ -51,9 +51,12 @@ public:
     MStatus getPoint(const int vertexId, MPoint& point) const;
     MStatus setPoint(const int vertexId, const MPoint& point) const;
     MStatus setPoints(const MIntArray& verticesIds, const MPointArray& points) const;
+    MStatus setAllPoints(const MPointArray& points) const;
     MStatus setBlindData(const int vertexId, std::vector<ClickedCSPosition>& data) const;
     MStatus getBlindData(const int vertexId, std::vector<ClickedCSPosition>& data) const;
     MStatus getBlindData(const int vertexId, std::map<int, MPoint>& cameraToClickedCSPoints) const;
+    MStatus getAllBlindData(std::vector<int>& vertexIds,
+                            std::vector<std::vector<ClickedCSPosition> >& data) const;
     MStatus unsetAllBlindData() const;
     MStatus unsetBlindData(const int vertexId) const;
     MStatus getBlindDataPerCamera(const int vertexId, const int cameraId, MPoint& point2D) const;
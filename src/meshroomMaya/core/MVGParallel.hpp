@@ -0,0 +1,25 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+
+namespace meshroomMaya
+{
+
+/**
+ * Split [0, count) in contiguous chunks and run func(chunk, begin, end) on each of them, one
+ * thread per chunk. The calling thread processes the first chunk.
+ */
+template <typename Func>
+void parallelForChunks(const size_t chunksCount, const size_t count, Func func)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(chunksCount - 1);
+    for(size_t c = 1; c < chunksCount; ++c)
+        threads.emplace_back(func, c, count * c / chunksCount, count * (c + 1) / chunksCount);
+    func(0, 0, count / chunksCount);
+    for(size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+}
+
+} // namespace
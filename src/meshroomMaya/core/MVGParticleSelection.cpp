@@ -0,0 +1,31 @@
+#include "meshroomMaya/core/MVGParticleSelection.hpp"
+#include <sstream>
+
+namespace meshroomMaya
+{
+
+/**
+ * @return the MEL command replacing the active selection by the given particles of the object,
+ * contiguous indexes being merged as pt[first:last] ranges
+ */
+std::string getSelectParticlesCommand(const std::string& objectName, const std::set<int>& points)
+{
+    std::ostringstream s;
+    s << "select -r ";
+    for(std::set<int>::const_iterator it = points.begin(); it != points.end();)
+    {
+        // extend the range while indexes are contiguous
+        const int first = *it;
+        int last = first;
+        for(++it; it != points.end() && *it == last + 1; ++it)
+            ++last;
+        s << objectName << ".pt[" << first;
+        if(last != first)
+            s << ":" << last;
+        s << "] ";
+    }
+    s << ";";
+    return s.str();
+}
+
+} // namespace
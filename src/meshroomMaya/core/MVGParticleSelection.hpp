@@ -0,0 +1,11 @@
+#pragma once
+
+#include <set>
+#include <string>
+
+namespace meshroomMaya
+{
+
+std::string getSelectParticlesCommand(const std::string& objectName, const std::set<int>& points);
+
+} // namespace
@@ -0,0 +1,175 @@
+#include "meshroomMaya/core/MVGPickingGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+// average number of boxes per cell
+static const double BOXES_PER_CELL = 2.0;
+// grid resolution limit (per axis)
+static const int MAX_CELLS_PER_AXIS = 512;
+
+int toCell(const double value, const double origin, const double cellSize, const int nbCells)
+{
+    // clamp before the cast to stay in the int range
+    const double cell = std::floor((value - origin) / cellSize);
+    return static_cast<int>(std::min(std::max(cell, 0.0), static_cast<double>(nbCells - 1)));
+}
+
+} // empty namespace
+
+MVGPickingGrid::Box::Box(const MPoint& point, const int id)
+    : minX(point.x)
+    , minY(point.y)
+    , maxX(point.x)
+    , maxY(point.y)
+    , id(id)
+{
+}
+
+MVGPickingGrid::Box::Box(const MPoint& A, const MPoint& B, const int id)
+    : minX(std::min(A.x, B.x))
+    , minY(std::min(A.y, B.y))
+    , maxX(std::max(A.x, B.x))
+    , maxY(std::max(A.y, B.y))
+    , id(id)
+{
+}
+
+MVGPickingGrid::MVGPickingGrid()
+    : _built(false)
+    , _hasMultiCellBoxes(false)
+    , _minX(0.0)
+    , _minY(0.0)
+    , _cellSize(1.0)
+    , _nbCellsX(0)
+    , _nbCellsY(0)
+{
+}
+
+void MVGPickingGrid::clear()
+{
+    _built = false;
+    _hasMultiCellBoxes = false;
+    _nbCellsX = 0;
+    _nbCellsY = 0;
+    _cellStart.clear();
+    _cellIds.clear();
+}
+
+void MVGPickingGrid::build(const std::vector<Box>& boxes)
+{
+    clear();
+    _built = true;
+    if(boxes.empty())
+        return;
+
+    // grid extent and mean box size
+    _minX = boxes[0].minX;
+    _minY = boxes[0].minY;
+    double maxX = boxes[0].maxX;
+    double maxY = boxes[0].maxY;
+    double meanBoxSize = 0.0;
+    for(std::vector<Box>::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+    {
+        _minX = std::min(_minX, it->minX);
+        _minY = std::min(_minY, it->minY);
+        maxX = std::max(maxX, it->maxX);
+        maxY = std::max(maxY, it->maxY);
+        meanBoxSize += std::max(it->maxX - it->minX, it->maxY - it->minY);
+    }
+    meanBoxSize /= boxes.size();
+    const double extentX = maxX - _minX;
+    const double extentY = maxY - _minY;
+    const double extent = std::max(extentX, extentY);
+    if(extent <= 0.0)
+    {
+        // all boxes are at the same position
+        _cellSize = 1.0;
+    }
+    else
+    {
+        // a few boxes per cell, cells not smaller than the boxes to limit multi cell entries
+        const double area = std::max(extentX, extent / MAX_CELLS_PER_AXIS) *
+                            std::max(extentY, extent / MAX_CELLS_PER_AXIS);
+        _cellSize = std::sqrt(area * BOXES_PER_CELL / boxes.size());
+        _cellSize = std::max(_cellSize, meanBoxSize);
+        _cellSize = std::max(_cellSize, extent / MAX_CELLS_PER_AXIS);
+    }
+    _nbCellsX = static_cast<int>(extentX / _cellSize) + 1;
+    _nbCellsY = static_cast<int>(extentY / _cellSize) + 1;
+
+    // counting sort of the boxes by cell (two passes: count, then fill)
+    _cellStart.assign(_nbCellsX * _nbCellsY + 1, 0);
+    int minCellX, minCellY, maxCellX, maxCellY;
+    for(std::vector<Box>::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+    {
+        getCellRange(it->minX, it->minY, it->maxX, it->maxY, minCellX, minCellY, maxCellX,
+                     maxCellY);
+        if(minCellX != maxCellX || minCellY != maxCellY)
+            _hasMultiCellBoxes = true;
+        for(int y = minCellY; y <= maxCellY; ++y)
+            for(int x = minCellX; x <= maxCellX; ++x)
+                ++_cellStart[y * _nbCellsX + x + 1];
+    }
+    for(size_t c = 1; c < _cellStart.size(); ++c)
+        _cellStart[c] += _cellStart[c - 1];
+    std::vector<int> fill(_cellStart.begin(), _cellStart.end() - 1);
+    _cellIds.resize(_cellStart.back());
+    for(std::vector<Box>::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+    {
+        getCellRange(it->minX, it->minY, it->maxX, it->maxY, minCellX, minCellY, maxCellX,
+                     maxCellY);
+        for(int y = minCellY; y <= maxCellY; ++y)
+            for(int x = minCellX; x <= maxCellX; ++x)
+                _cellIds[fill[y * _nbCellsX + x]++] = it->id;
+    }
+}
+
+/**
+ * @param[in] center : query center
+ * @param[in] radius : half size of the query square
+ * @param[out] ids : ids of the boxes registered in the cells overlapping the query square
+ */
+void MVGPickingGrid::getCandidates(const MPoint& center, const double radius,
+                                   std::vector<int>& ids) const
+{
+    ids.clear();
+    if(_nbCellsX == 0 || _nbCellsY == 0)
+        return;
+    const double maxX = _minX + _nbCellsX * _cellSize;
+    const double maxY = _minY + _nbCellsY * _cellSize;
+    if(center.x + radius < _minX || center.y + radius < _minY || center.x - radius > maxX ||
+       center.y - radius > maxY)
+        return;
+    int minCellX, minCellY, maxCellX, maxCellY;
+    getCellRange(center.x - radius, center.y - radius, center.x + radius, center.y + radius,
+                 minCellX, minCellY, maxCellX, maxCellY);
+    for(int y = minCellY; y <= maxCellY; ++y)
+    {
+        const int rowStart = y * _nbCellsX;
+        ids.insert(ids.end(), _cellIds.begin() + _cellStart[rowStart + minCellX],
+                   _cellIds.begin() + _cellStart[rowStart + maxCellX + 1]);
+    }
+    if(_hasMultiCellBoxes)
+    {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+}
+
+void MVGPickingGrid::getCellRange(const double minX, const double minY, const double maxX,
+                                  const double maxY, int& minCellX, int& minCellY, int& maxCellX,
+                                  int& maxCellY) const
+{
+    minCellX = toCell(minX, _minX, _cellSize, _nbCellsX);
+    minCellY = toCell(minY, _minY, _cellSize, _nbCellsY);
+    maxCellX = toCell(maxX, _minX, _cellSize, _nbCellsX);
+    maxCellY = toCell(maxY, _minY, _cellSize, _nbCellsY);
+}
+
+} // namespace
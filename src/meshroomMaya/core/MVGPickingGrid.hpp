@@ -0,0 +1,65 @@
+#pragma once
+
+#include <maya/MPoint.h>
+#include <vector>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Uniform 2D grid of axis aligned boxes, used to answer picking queries.
+ *
+ * Each box is registered in every cell it overlaps. Points are stored as degenerate boxes.
+ * Queries return the ids of the boxes registered in the cells overlapping the query square,
+ * exact distance tests are left to the caller.
+ */
+class MVGPickingGrid
+{
+
+public:
+    struct Box
+    {
+        Box()
+            : minX(0.0)
+            , minY(0.0)
+            , maxX(0.0)
+            , maxY(0.0)
+            , id(-1)
+        {
+        }
+        Box(const MPoint& point, const int id);
+        Box(const MPoint& A, const MPoint& B, const int id);
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+        int id;
+    };
+
+public:
+    MVGPickingGrid();
+
+public:
+    void clear();
+    bool isBuilt() const { return _built; }
+    void build(const std::vector<Box>& boxes);
+    void getCandidates(const MPoint& center, const double radius, std::vector<int>& ids) const;
+
+private:
+    void getCellRange(const double minX, const double minY, const double maxX, const double maxY,
+                      int& minCellX, int& minCellY, int& maxCellX, int& maxCellY) const;
+
+private:
+    bool _built;
+    bool _hasMultiCellBoxes; // queries may return duplicated ids
+    double _minX;
+    double _minY;
+    double _cellSize;
+    int _nbCellsX;
+    int _nbCellsY;
+    /// box ids sorted by cell, _cellStart[c] to _cellStart[c+1] being the range of cell c
+    std::vector<int> _cellStart;
+    std::vector<int> _cellIds;
+};
+
+} // namespace
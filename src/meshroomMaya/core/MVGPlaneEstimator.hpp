@@ -0,0 +1,212 @@
+#pragma once
+
+#include "MVGEigen.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Settings of the robust estimation of a plane from the enclosed points of a face.
+ */
+struct MVGPlaneEstimatorOptions
+{
+    enum EMethod
+    {
+        eMethodLMedS = 0, // aliceVision LeastMedianOfSquares, tests every sample
+        eMethodRansac,    // adaptive RANSAC, uniform sampling
+        eMethodProsac     // adaptive RANSAC, samples drawn from the best weighted points first
+    };
+
+    MVGPlaneEstimatorOptions()
+        : method(eMethodRansac)
+        , maxIterations(500)
+        , confidence(0.99)
+        , thresholdRatio(0.01)
+    {
+    }
+
+    EMethod method;
+    /// iteration budget, the estimation stops earlier once the confidence is reached
+    size_t maxIterations;
+    /// probability of having drawn at least one outlier free sample before stopping
+    double confidence;
+    /// inlier distance to the plane, relative to the bounding box diagonal of the points
+    double thresholdRatio;
+};
+
+namespace robustPlane
+{ // robust plane estimation
+
+/// Number of iterations needed to draw an outlier free sample with the given confidence
+inline size_t requiredIterations(const double inlierRatio, const size_t minimumSamples,
+                                 const double confidence, const size_t maxIterations)
+{
+    const double outlierFreeSample = std::pow(inlierRatio, static_cast<double>(minimumSamples));
+    if(outlierFreeSample >= 1.0)
+        return 1;
+    if(outlierFreeSample <= 0.0)
+        return maxIterations;
+    const double iterations = std::log(1.0 - confidence) / std::log(1.0 - outlierFreeSample);
+    if(!(iterations < maxIterations))
+        return maxIterations;
+    return static_cast<size_t>(std::ceil(iterations));
+}
+
+/// Draw 'count' distinct indexes in [0, range[
+inline void drawSample(std::mt19937& generator, const size_t range, const size_t count,
+                       std::vector<size_t>& sample)
+{
+    std::uniform_int_distribution<size_t> distribution(0, range - 1);
+    while(sample.size() < count)
+    {
+        const size_t index = distribution(generator);
+        if(std::find(sample.begin(), sample.end(), index) == sample.end())
+            sample.push_back(index);
+    }
+}
+
+/**
+ * Adaptive RANSAC (MSAC scoring), with optional PROSAC sampling, followed by a least-squares
+ * refit of the model on the inliers of the best hypothesis.
+ *
+ * The random generator is seeded identically on each call, so that the same points always
+ * give the same plane: faces do not jitter from one drag event to the next.
+ *
+ * @param[in] kernel : PlaneKernel-like kernel, providing Fit, Refit and Error
+ * @param[in] options : iteration budget, confidence and inlier threshold
+ * @param[in] weights : quality of each point for PROSAC ordering, uniform sampling if empty
+ * @param[out] model : estimated plane
+ * @param[out] inliers : optional, indexes of the points within the threshold of the plane
+ * @return false if no model could be estimated
+ */
+template <typename Kernel>
+bool estimate(const Kernel& kernel, const MVGPlaneEstimatorOptions& options,
+              const std::vector<double>& weights, typename Kernel::Model& model,
+              std::vector<size_t>* inliers = NULL)
+{
+    const size_t samplesCount = kernel.NumSamples();
+    const size_t minimumSamples = Kernel::MINIMUM_SAMPLES;
+    if(samplesCount < minimumSamples || options.maxIterations == 0)
+        return false;
+
+    // inlier threshold, from the extent of the points
+    const aliceVision::Mat& points = kernel._pt;
+    const aliceVision::Vec3 extent = points.rowwise().maxCoeff() - points.rowwise().minCoeff();
+    const double threshold = std::max(options.thresholdRatio * extent.norm(),
+                                      std::numeric_limits<double>::epsilon());
+    const double squaredThreshold = threshold * threshold;
+
+    // samples order, best weighted points first for PROSAC
+    std::vector<size_t> order(samplesCount);
+    std::iota(order.begin(), order.end(), 0);
+    const bool prosac = options.method == MVGPlaneEstimatorOptions::eMethodProsac &&
+                        weights.size() == samplesCount;
+    if(prosac)
+        std::stable_sort(order.begin(), order.end(), [&weights](size_t a, size_t b)
+                         {
+                             return weights[a] > weights[b];
+                         });
+
+    // PROSAC growth function (Chum & Matas, 2005): T'n is the iteration from which the
+    // sampling set grows to the n+1 best points
+    size_t prosacSize = minimumSamples;
+    double prosacTn = static_cast<double>(options.maxIterations);
+    for(size_t i = 0; i < minimumSamples; ++i)
+        prosacTn *= static_cast<double>(minimumSamples - i) / (samplesCount - i);
+    size_t prosacTnPrime = 1;
+
+    std::mt19937 generator(0);
+    std::vector<size_t> sample, sampleIndexes;
+    std::vector<typename Kernel::Model> hypotheses;
+    size_t bestInliersCount = 0;
+    double bestCost = std::numeric_limits<double>::infinity();
+    size_t iterationsNeeded = options.maxIterations;
+    for(size_t iteration = 1; iteration <= iterationsNeeded; ++iteration)
+    {
+        sample.clear();
+        if(prosac)
+        {
+            if(iteration == prosacTnPrime && prosacSize < samplesCount)
+            {
+                const double nextTn =
+                    prosacTn * (prosacSize + 1) / (prosacSize + 1 - minimumSamples);
+                prosacTnPrime += static_cast<size_t>(std::ceil(nextTn - prosacTn));
+                prosacTn = nextTn;
+                ++prosacSize;
+            }
+            if(prosacTnPrime < iteration)
+                drawSample(generator, prosacSize, minimumSamples, sample);
+            else
+            {
+                // the newly added point, and the others among the previous best ones
+                sample.push_back(prosacSize - 1);
+                drawSample(generator, prosacSize - 1, minimumSamples, sample);
+            }
+        }
+        else
+            drawSample(generator, samplesCount, minimumSamples, sample);
+
+        sampleIndexes.resize(sample.size());
+        for(size_t i = 0; i < sample.size(); ++i)
+            sampleIndexes[i] = order[sample[i]];
+        kernel.Fit(sampleIndexes, &hypotheses);
+
+        for(size_t h = 0; h < hypotheses.size(); ++h)
+        {
+            // MSAC score, stop as soon as the hypothesis can't reach the best inliers count
+            size_t inliersCount = 0;
+            double cost = 0.0;
+            size_t i = 0;
+            for(; i < samplesCount && inliersCount + (samplesCount - i) >= bestInliersCount; ++i)
+            {
+                const double error = kernel.Error(i, hypotheses[h]);
+                const double squaredError = error * error;
+                if(squaredError <= squaredThreshold)
+                {
+                    ++inliersCount;
+                    cost += squaredError;
+                }
+                else
+                    cost += squaredThreshold;
+            }
+            if(i < samplesCount || inliersCount < bestInliersCount ||
+               (inliersCount == bestInliersCount && cost >= bestCost))
+                continue;
+            bestInliersCount = inliersCount;
+            bestCost = cost;
+            model = hypotheses[h];
+            // adaptive stop, from the best inlier ratio so far
+            const size_t required =
+                requiredIterations(static_cast<double>(inliersCount) / samplesCount,
+                                   minimumSamples, options.confidence, options.maxIterations);
+            iterationsNeeded = std::min(iterationsNeeded, std::max(iteration, required));
+        }
+    }
+    if(bestInliersCount < minimumSamples)
+        return false;
+
+    // least-squares refit on the inliers
+    std::vector<size_t> bestInliers;
+    bestInliers.reserve(bestInliersCount);
+    for(size_t i = 0; i < samplesCount; ++i)
+    {
+        if(kernel.Error(i, model) <= threshold)
+            bestInliers.push_back(i);
+    }
+    typename Kernel::Model refined;
+    if(kernel.Refit(bestInliers, refined))
+        model = refined;
+    if(inliers)
+        inliers->swap(bestInliers);
+    return true;
+}
+
+} // robust plane estimation
+
+} // namespace
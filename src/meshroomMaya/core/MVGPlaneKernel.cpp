@@ -35,5 +35,29 @@ void PlaneKernel::Fit(const std::vector<size_t>& samples, std::vector<Model>* eq
     equation->push_back(m);
 }
 
+bool PlaneKernel::Refit(const std::vector<size_t>& samples, Model& equation) const
+{
+    if(samples.size() < MINIMUM_SAMPLES)
+        return false;
+    aliceVision::Vec3 centroid = aliceVision::Vec3::Zero();
+    for(size_t i = 0; i < samples.size(); ++i)
+        centroid += _pt.col(samples[i]);
+    centroid /= static_cast<double>(samples.size());
+    aliceVision::Mat3 covariance = aliceVision::Mat3::Zero();
+    for(size_t i = 0; i < samples.size(); ++i)
+    {
+        const aliceVision::Vec3 centered = _pt.col(samples[i]) - centroid;
+        covariance += centered * centered.transpose();
+    }
+    // The normal is the direction of least variance
+    Eigen::SelfAdjointEigenSolver<aliceVision::Mat3> solver(covariance);
+    if(solver.info() != Eigen::Success || solver.eigenvalues()(1) <= 0.0)
+        return false;
+    const aliceVision::Vec3 normal = solver.eigenvectors().col(0);
+    equation.head<3>() = normal;
+    equation[3] = -1.0 * normal.dot(centroid);
+    return true;
+}
+
 
 } // namespace
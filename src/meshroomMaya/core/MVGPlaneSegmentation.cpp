@@ -0,0 +1,585 @@
+#include "meshroomMaya/core/MVGPlaneSegmentation.hpp"
+#include "meshroomMaya/core/MVGPointCloudStore.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+static const int GRID_OFFSET = 1 << 20;
+static const int GRID_MAX = (1 << 21) - 1;
+static const size_t MAX_LOCAL_POINTS = 1024;
+static const size_t EXTENT_SAMPLES = 10000;
+static const int MAX_REFINEMENTS = 32;
+/// a region is merged into an adjacent plane when their normals are this close (cosine) and
+/// its points are, on average, this close to the plane (relative to the inlier distance)
+static const double MIN_MERGE_NORMALS_COSINE = 0.99; // ~8 degrees
+static const double MAX_MERGE_OFFSET_RATIO = 2.0;
+
+/// Uniform grid over the points, cells being addressed by their packed integer coordinates
+struct Grid
+{
+    Grid(const aliceVision::Vec3& origin, const double cellSize)
+        : _origin(origin)
+        , _cellSize(cellSize)
+    {
+    }
+
+    int cellCoord(const double value, const int axis) const
+    {
+        const double coord = std::floor((value - _origin(axis)) / _cellSize) + GRID_OFFSET;
+        return static_cast<int>(std::min(std::max(coord, 0.0), static_cast<double>(GRID_MAX)));
+    }
+
+    static uint64_t cellKey(const int x, const int y, const int z)
+    {
+        return (static_cast<uint64_t>(x) << 42) | (static_cast<uint64_t>(y) << 21) |
+               static_cast<uint64_t>(z);
+    }
+
+    int findCell(const int x, const int y, const int z) const
+    {
+        if(x < 0 || y < 0 || z < 0 || x > GRID_MAX || y > GRID_MAX || z > GRID_MAX)
+            return -1;
+        const auto it = _cellIndexes.find(cellKey(x, y, z));
+        return it == _cellIndexes.end() ? -1 : it->second;
+    }
+
+    void build(const double* x, const double* y, const double* z, const size_t count)
+    {
+        _pointCells.resize(count);
+        for(size_t i = 0; i < count; ++i)
+        {
+            const int cx = cellCoord(x[i], 0);
+            const int cy = cellCoord(y[i], 1);
+            const int cz = cellCoord(z[i], 2);
+            auto inserted = _cellIndexes.insert(
+                std::make_pair(cellKey(cx, cy, cz), static_cast<int>(_cellCoords.size() / 3)));
+            if(inserted.second)
+            {
+                _cellCoords.push_back(cx);
+                _cellCoords.push_back(cy);
+                _cellCoords.push_back(cz);
+            }
+            _pointCells[i] = inserted.first->second;
+        }
+        // points sorted by cell
+        const size_t cellsCount = _cellCoords.size() / 3;
+        _cellStart.assign(cellsCount + 1, 0);
+        for(size_t i = 0; i < count; ++i)
+            ++_cellStart[_pointCells[i] + 1];
+        for(size_t c = 0; c < cellsCount; ++c)
+            _cellStart[c + 1] += _cellStart[c];
+        _cellPoints.resize(count);
+        std::vector<int> cursor(_cellStart.begin(), _cellStart.end() - 1);
+        for(size_t i = 0; i < count; ++i)
+            _cellPoints[cursor[_pointCells[i]]++] = static_cast<int>(i);
+    }
+
+    /// the cell and its (up to) 26 neighbours
+    void getNeighbourCells(const int cell, std::vector<int>& neighbours) const
+    {
+        neighbours.clear();
+        const int* coords = &_cellCoords[3 * cell];
+        for(int dx = -1; dx <= 1; ++dx)
+            for(int dy = -1; dy <= 1; ++dy)
+                for(int dz = -1; dz <= 1; ++dz)
+                {
+                    const int neighbour = findCell(coords[0] + dx, coords[1] + dy, coords[2] + dz);
+                    if(neighbour >= 0)
+                        neighbours.push_back(neighbour);
+                }
+    }
+
+    size_t getCellsCount() const { return _cellStart.empty() ? 0 : _cellStart.size() - 1; }
+
+    aliceVision::Vec3 _origin;
+    double _cellSize;
+    std::unordered_map<uint64_t, int> _cellIndexes;
+    std::vector<int> _cellCoords;
+    std::vector<int> _pointCells;
+    /// _cellPoints[_cellStart[c]] to _cellPoints[_cellStart[c+1]] are the points of cell c
+    std::vector<int> _cellStart;
+    std::vector<int> _cellPoints;
+};
+
+/// Robust bounds of the points, ignoring the outermost percent on each axis
+bool getExtent(const double* x, const double* y, const double* z, const size_t count,
+               aliceVision::Vec3& minPoint, aliceVision::Vec3& maxPoint)
+{
+    if(count == 0)
+        return false;
+    const size_t step = std::max(count / EXTENT_SAMPLES, static_cast<size_t>(1));
+    const double* coords[] = {x, y, z};
+    std::vector<double> values;
+    for(int axis = 0; axis < 3; ++axis)
+    {
+        values.clear();
+        for(size_t i = 0; i < count; i += step)
+            values.push_back(coords[axis][i]);
+        const size_t low = values.size() / 100;
+        const size_t high = values.size() - 1 - low;
+        std::nth_element(values.begin(), values.begin() + low, values.end());
+        minPoint(axis) = values[low];
+        std::nth_element(values.begin(), values.begin() + high, values.end());
+        maxPoint(axis) = values[high];
+    }
+    return (maxPoint - minPoint).norm() > 0.0;
+}
+
+/// Least-squares plane of the given points, as the direction of least variance
+bool fitPlane(const double* x, const double* y, const double* z, const std::vector<int>& points,
+              aliceVision::Vec4& plane)
+{
+    if(points.size() < 3)
+        return false;
+    const aliceVision::Vec3 origin(x[points[0]], y[points[0]], z[points[0]]);
+    aliceVision::Vec3 sum = aliceVision::Vec3::Zero();
+    aliceVision::Mat3 sumSquares = aliceVision::Mat3::Zero();
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+        const aliceVision::Vec3 p =
+            aliceVision::Vec3(x[points[i]], y[points[i]], z[points[i]]) - origin;
+        sum += p;
+        sumSquares += p * p.transpose();
+    }
+    const aliceVision::Vec3 mean = sum / static_cast<double>(points.size());
+    const aliceVision::Mat3 covariance =
+        sumSquares / static_cast<double>(points.size()) - mean * mean.transpose();
+    Eigen::SelfAdjointEigenSolver<aliceVision::Mat3> solver(covariance);
+    if(solver.info() != Eigen::Success || solver.eigenvalues()(1) <= 0.0)
+        return false;
+    const aliceVision::Vec3 normal = solver.eigenvectors().col(0);
+    plane.head<3>() = normal;
+    plane(3) = -1.0 * normal.dot(origin + mean);
+    return true;
+}
+
+inline double planeDistance(const aliceVision::Vec4& plane, const double x, const double y,
+                            const double z)
+{
+    return std::fabs(plane(0) * x + plane(1) * y + plane(2) * z + plane(3));
+}
+
+} // empty namespace
+
+MVGPlaneSegmentation::Options::Options()
+    : distanceRatio(0.003)
+    , cellRatio(0.01)
+    , minPlanePoints(50)
+    , minPlaneRatio(0.001)
+    , hypothesesPerSeed(16)
+    , maxFailures(200)
+    , maxPlanes(500)
+{
+}
+
+void MVGPlaneSegmentation::clear()
+{
+    _pointPlanes.clear();
+    _planes.clear();
+}
+
+void MVGPlaneSegmentation::swap(MVGPlaneSegmentation& other)
+{
+    _pointPlanes.swap(other._pointPlanes);
+    _planes.swap(other._planes);
+}
+
+/**
+ * Take ownership of already computed arrays (the given ones are left empty).
+ *
+ * @param[in] pointPlanes : plane id of each point
+ * @param[in] planes : plane equations, 4 values per plane
+ * @return false if the arrays are not consistent, the segmentation being left untouched
+ */
+bool MVGPlaneSegmentation::assign(std::vector<int>& pointPlanes, std::vector<double>& planes)
+{
+    if(planes.size() % 4 != 0)
+        return false;
+    const int planesCount = static_cast<int>(planes.size() / 4);
+    for(size_t i = 0; i < pointPlanes.size(); ++i)
+    {
+        if(pointPlanes[i] < -1 || pointPlanes[i] >= planesCount)
+            return false;
+    }
+    _pointPlanes.swap(pointPlanes);
+    _planes.swap(planes);
+    pointPlanes.clear();
+    planes.clear();
+    return true;
+}
+
+/**
+ * Sequential RANSAC: at each round, the hypotheses drawn around a random seed point are scored
+ * on the neighbourhood of the seed, and the best one, refitted on its local inliers, is grown
+ * over the connected grid cells holding points close to it. The plane is refitted on the grown
+ * region and grown again until the region does not change anymore. A region that is a fragment
+ * of an adjacent plane (same orientation, points centered on that plane) is merged into it,
+ * otherwise it is labelled as a new plane. Stops once too many seeds in a row failed to grow a
+ * plane.
+ *
+ * @param[in] cancel : optional, the computation is interrupted when set
+ * @return false if the computation has been cancelled
+ */
+bool MVGPlaneSegmentation::compute(const double* x, const double* y, const double* z,
+                                   const size_t count, const Options& options,
+                                   const std::atomic<bool>* cancel)
+{
+    clear();
+    _pointPlanes.assign(count, -1);
+    const size_t minPlanePoints = std::max(
+        std::max(options.minPlanePoints, static_cast<size_t>(options.minPlaneRatio * count)),
+        static_cast<size_t>(3));
+    aliceVision::Vec3 minPoint, maxPoint;
+    if(count < minPlanePoints || !getExtent(x, y, z, count, minPoint, maxPoint))
+        return true;
+    const double extent = (maxPoint - minPoint).norm();
+    const double threshold = options.distanceRatio * extent;
+    Grid grid(minPoint, options.cellRatio * extent);
+    grid.build(x, y, z, count);
+
+    std::mt19937 generator(0);
+    std::vector<int> unassigned(count);
+    for(size_t i = 0; i < count; ++i)
+        unassigned[i] = static_cast<int>(i);
+    size_t assignedCount = 0;
+    std::vector<int> cellStamps(grid.getCellsCount(), -1);
+    int stamp = 0;
+    std::vector<int> neighbours, local, cells, region, refinedRegion, adjacentPlanes;
+    /// points of each plane, to refit planes when fragments are merged into them
+    std::vector<std::vector<int> > planesPoints;
+
+    // points of the connected cells holding unassigned points close to the plane
+    auto grow = [&](const int seedCell, const aliceVision::Vec4& plane, std::vector<int>& grown)
+    {
+        grown.clear();
+        cells.assign(1, seedCell);
+        cellStamps[seedCell] = ++stamp;
+        for(size_t c = 0; c < cells.size(); ++c)
+        {
+            bool accepted = false;
+            for(int i = grid._cellStart[cells[c]]; i < grid._cellStart[cells[c] + 1]; ++i)
+            {
+                const int p = grid._cellPoints[i];
+                if(_pointPlanes[p] != -1 || planeDistance(plane, x[p], y[p], z[p]) > threshold)
+                    continue;
+                grown.push_back(p);
+                accepted = true;
+            }
+            if(!accepted)
+                continue;
+            grid.getNeighbourCells(cells[c], neighbours);
+            for(size_t n = 0; n < neighbours.size(); ++n)
+            {
+                if(cellStamps[neighbours[n]] == stamp)
+                    continue;
+                cellStamps[neighbours[n]] = stamp;
+                cells.push_back(neighbours[n]);
+            }
+        }
+    };
+
+    // planes labelled in the cells around the points
+    auto getAdjacentPlanes = [&](const std::vector<int>& points, std::vector<int>& planeIds)
+    {
+        planeIds.clear();
+        ++stamp;
+        for(size_t i = 0; i < points.size(); ++i)
+        {
+            const int cell = grid._pointCells[points[i]];
+            if(cellStamps[cell] == stamp)
+                continue;
+            cellStamps[cell] = stamp;
+            grid.getNeighbourCells(cell, neighbours);
+            for(size_t n = 0; n < neighbours.size(); ++n)
+            {
+                for(int j = grid._cellStart[neighbours[n]];
+                    j < grid._cellStart[neighbours[n] + 1]; ++j)
+                {
+                    const int planeId = _pointPlanes[grid._cellPoints[j]];
+                    if(planeId != -1 &&
+                       std::find(planeIds.begin(), planeIds.end(), planeId) == planeIds.end())
+                        planeIds.push_back(planeId);
+                }
+            }
+        }
+    };
+
+    // adjacent plane the region is a fragment of, -1 if none
+    auto findMergePlane = [&](const std::vector<int>& points, const aliceVision::Vec4& plane)
+    {
+        getAdjacentPlanes(points, adjacentPlanes);
+        for(size_t i = 0; i < adjacentPlanes.size(); ++i)
+        {
+            const aliceVision::Vec4 other = getPlane(adjacentPlanes[i]);
+            if(std::fabs(other.head<3>().dot(plane.head<3>())) < MIN_MERGE_NORMALS_COSINE)
+                continue;
+            // signed: a fragment of the plane is centered on it, even if tilted
+            double offset = 0.0;
+            for(size_t j = 0; j < points.size(); ++j)
+            {
+                const int p = points[j];
+                offset += other.dot(aliceVision::Vec4(x[p], y[p], z[p], 1.0));
+            }
+            if(std::fabs(offset) <= MAX_MERGE_OFFSET_RATIO * threshold * points.size())
+                return adjacentPlanes[i];
+        }
+        return -1;
+    };
+
+    size_t failures = 0;
+    while(failures < options.maxFailures && getPlanesCount() < options.maxPlanes &&
+          count - assignedCount >= minPlanePoints)
+    {
+        if(cancel && *cancel)
+        {
+            clear();
+            return false;
+        }
+        // drop the assigned points once they are the majority of the seed candidates
+        if(2 * (unassigned.size() - (count - assignedCount)) > unassigned.size())
+            unassigned.erase(std::remove_if(unassigned.begin(), unassigned.end(),
+                                            [this](int p) { return _pointPlanes[p] != -1; }),
+                             unassigned.end());
+        const int seed = unassigned[std::uniform_int_distribution<size_t>(
+            0, unassigned.size() - 1)(generator)];
+        if(_pointPlanes[seed] != -1)
+            continue;
+        ++failures;
+
+        // unassigned neighbourhood of the seed
+        const int seedCell = grid._pointCells[seed];
+        grid.getNeighbourCells(seedCell, neighbours);
+        local.clear();
+        for(size_t n = 0; n < neighbours.size(); ++n)
+        {
+            for(int i = grid._cellStart[neighbours[n]]; i < grid._cellStart[neighbours[n] + 1];
+                ++i)
+            {
+                const int p = grid._cellPoints[i];
+                if(p != seed && _pointPlanes[p] == -1)
+                    local.push_back(p);
+            }
+        }
+        if(local.size() < 2)
+            continue;
+        if(local.size() > MAX_LOCAL_POINTS)
+        {
+            for(size_t i = 0; i < MAX_LOCAL_POINTS; ++i)
+                std::swap(local[i], local[std::uniform_int_distribution<size_t>(
+                                        i, local.size() - 1)(generator)]);
+            local.resize(MAX_LOCAL_POINTS);
+        }
+
+        // best plane through the seed and two of its neighbours
+        const aliceVision::Vec3 p0(x[seed], y[seed], z[seed]);
+        std::uniform_int_distribution<size_t> localDistribution(0, local.size() - 1);
+        aliceVision::Vec4 bestPlane;
+        size_t bestScore = 0;
+        for(size_t h = 0; h < options.hypothesesPerSeed; ++h)
+        {
+            const int i1 = local[localDistribution(generator)];
+            const int i2 = local[localDistribution(generator)];
+            if(i1 == i2)
+                continue;
+            const aliceVision::Vec3 normal =
+                (aliceVision::Vec3(x[i1], y[i1], z[i1]) - p0)
+                    .cross(aliceVision::Vec3(x[i2], y[i2], z[i2]) - p0);
+            if(normal.norm() <= threshold * threshold)
+                continue;
+            aliceVision::Vec4 plane;
+            plane.head<3>() = normal.normalized();
+            plane(3) = -1.0 * plane.head<3>().dot(p0);
+            size_t score = 0;
+            for(size_t i = 0; i < local.size(); ++i)
+            {
+                if(planeDistance(plane, x[local[i]], y[local[i]], z[local[i]]) <= threshold)
+                    ++score;
+            }
+            if(score > bestScore)
+            {
+                bestScore = score;
+                bestPlane = plane;
+            }
+        }
+        if(bestScore < 2)
+            continue;
+        // least-squares plane of the local inliers
+        region.clear();
+        region.push_back(seed);
+        for(size_t i = 0; i < local.size(); ++i)
+        {
+            if(planeDistance(bestPlane, x[local[i]], y[local[i]], z[local[i]]) <= threshold)
+                region.push_back(local[i]);
+        }
+        aliceVision::Vec4 refinedPlane;
+        if(fitPlane(x, y, z, region, refinedPlane))
+            bestPlane = refinedPlane;
+
+        // grow, then refit on the region and grow again while the region extends
+        grow(seedCell, bestPlane, region);
+        if(region.size() < minPlanePoints)
+            continue;
+        for(int refinement = 0; refinement < MAX_REFINEMENTS; ++refinement)
+        {
+            if(!fitPlane(x, y, z, region, refinedPlane))
+                break;
+            grow(seedCell, refinedPlane, refinedRegion);
+            if(refinedRegion.size() < minPlanePoints)
+                break;
+            bestPlane = refinedPlane;
+            // same cells and points in the same order: the region is stable
+            if(refinedRegion == region)
+                break;
+            region.swap(refinedRegion);
+        }
+
+        // fragment of an adjacent plane (split by a previous, less accurate, estimation of
+        // that plane): merge it and refit the plane, instead of adding a new one
+        int planeId = findMergePlane(region, bestPlane);
+        if(planeId == -1)
+        {
+            planeId = static_cast<int>(getPlanesCount());
+            _planes.insert(_planes.end(), bestPlane.data(), bestPlane.data() + 4);
+            planesPoints.push_back(region);
+        }
+        else
+        {
+            std::vector<int>& planePoints = planesPoints[planeId];
+            planePoints.insert(planePoints.end(), region.begin(), region.end());
+            if(fitPlane(x, y, z, planePoints, refinedPlane))
+                std::copy(refinedPlane.data(), refinedPlane.data() + 4, &_planes[4 * planeId]);
+        }
+        for(size_t i = 0; i < region.size(); ++i)
+            _pointPlanes[region[i]] = planeId;
+        assignedCount += region.size();
+        failures = 0;
+    }
+    return true;
+}
+
+aliceVision::Vec4 MVGPlaneSegmentation::getPlane(const int planeId) const
+{
+    const double* plane = &_planes[4 * planeId];
+    return aliceVision::Vec4(plane[0], plane[1], plane[2], plane[3]);
+}
+
+/**
+ * Majority vote over the plane ids of the given points.
+ *
+ * @param[in] points : point indexes
+ * @param[in] minRatio : smallest part of the points the plane has to hold, at least 0.5
+ * @param[out] plane : equation of the plane holding most of the points
+ * @return false if no plane holds enough of the points
+ */
+bool MVGPlaneSegmentation::getDominantPlane(const std::vector<int>& points,
+                                            const double minRatio,
+                                            aliceVision::Vec4& plane) const
+{
+    if(points.size() < 3 || empty())
+        return false;
+    // Boyer-Moore majority vote, then check the candidate
+    int candidate = -1;
+    size_t votes = 0;
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+        if(points[i] < 0 || static_cast<size_t>(points[i]) >= _pointPlanes.size())
+            return false;
+        const int planeId = _pointPlanes[points[i]];
+        if(votes == 0)
+            candidate = planeId;
+        if(planeId == candidate)
+            ++votes;
+        else
+            --votes;
+    }
+    if(candidate < 0)
+        return false;
+    size_t planePoints = 0;
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+        if(_pointPlanes[points[i]] == candidate)
+            ++planePoints;
+    }
+    if(planePoints < 3 || planePoints < std::max(minRatio, 0.5) * points.size())
+        return false;
+    plane = getPlane(candidate);
+    return true;
+}
+
+MVGPlaneSegmentationTask::MVGPlaneSegmentationTask()
+    : _cancel(false)
+    , _hasResult(false)
+{
+}
+
+MVGPlaneSegmentationTask::~MVGPlaneSegmentationTask()
+{
+    cancel();
+}
+
+/**
+ * Cancel the running computation if any, then compute the segmentation of a copy of the store.
+ *
+ * @param[in] onDone : called from the worker thread once the result can be taken
+ */
+void MVGPlaneSegmentationTask::start(const MVGPointCloudStore& store,
+                                     const MVGPlaneSegmentation::Options& options,
+                                     const std::function<void()>& onDone)
+{
+    cancel();
+    _cancel = false;
+    std::vector<double> x(store.getXData(), store.getXData() + store.size());
+    std::vector<double> y(store.getYData(), store.getYData() + store.size());
+    std::vector<double> z(store.getZData(), store.getZData() + store.size());
+    _thread = std::thread(&MVGPlaneSegmentationTask::run, this, std::move(x), std::move(y),
+                          std::move(z), options, onDone);
+}
+
+/**
+ * Stop the running computation, and discard any result not taken yet.
+ */
+void MVGPlaneSegmentationTask::cancel()
+{
+    _cancel = true;
+    if(_thread.joinable())
+        _thread.join();
+    std::lock_guard<std::mutex> lock(_mutex);
+    _result.clear();
+    _hasResult = false;
+}
+
+bool MVGPlaneSegmentationTask::takeResult(MVGPlaneSegmentation& result)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(!_hasResult)
+        return false;
+    result.swap(_result);
+    _result.clear();
+    _hasResult = false;
+    return true;
+}
+
+void MVGPlaneSegmentationTask::run(std::vector<double> x, std::vector<double> y,
+                                   std::vector<double> z, MVGPlaneSegmentation::Options options,
+                                   std::function<void()> onDone)
+{
+    MVGPlaneSegmentation segmentation;
+    if(!segmentation.compute(x.data(), y.data(), z.data(), x.size(), options, &_cancel))
+        return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _result.swap(segmentation);
+        _hasResult = true;
+    }
+    if(onDone)
+        onDone();
+}
+
+} // namespace
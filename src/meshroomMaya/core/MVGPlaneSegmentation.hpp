@@ -0,0 +1,103 @@
+#pragma once
+
+#include "MVGEigen.hpp"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace meshroomMaya
+{
+
+class MVGPointCloudStore;
+
+/**
+ * @brief Planes of the point cloud, and the plane each point belongs to.
+ *
+ * Computed once per project by sequential RANSAC: hypotheses are drawn around a random seed
+ * point, the best one is grown over the connected cells of a uniform 3D grid, refitted by least
+ * squares, and its points are removed before the next round. Projections can then use the
+ * dominant plane of the enclosed points instead of estimating one.
+ * Plane ids are indexes in the plane list, -1 for the points that belong to no plane.
+ * This class does not depend on Maya.
+ */
+class MVGPlaneSegmentation
+{
+
+public:
+    struct Options
+    {
+        Options();
+        /// inlier distance to a plane, relative to the point cloud extent
+        double distanceRatio;
+        /// grid cell size (connectivity distance), relative to the point cloud extent
+        double cellRatio;
+        /// smallest number of points for a plane to be kept, absolute and relative to the
+        /// point cloud size
+        size_t minPlanePoints;
+        double minPlaneRatio;
+        /// hypotheses drawn around each seed point
+        size_t hypothesesPerSeed;
+        /// number of consecutive seeds growing no plane before stopping
+        size_t maxFailures;
+        size_t maxPlanes;
+    };
+
+public:
+    void clear();
+    void swap(MVGPlaneSegmentation& other);
+    bool assign(std::vector<int>& pointPlanes, std::vector<double>& planes);
+    bool compute(const double* x, const double* y, const double* z, const size_t count,
+                 const Options& options, const std::atomic<bool>* cancel = NULL);
+
+public:
+    bool empty() const { return _pointPlanes.empty(); }
+    size_t getPointsCount() const { return _pointPlanes.size(); }
+    size_t getPlanesCount() const { return _planes.size() / 4; }
+    int getPointPlane(const size_t point) const { return _pointPlanes[point]; }
+    aliceVision::Vec4 getPlane(const int planeId) const;
+    bool getDominantPlane(const std::vector<int>& points, const double minRatio,
+                          aliceVision::Vec4& plane) const;
+    const std::vector<int>& getPointPlanes() const { return _pointPlanes; }
+    const std::vector<double>& getPlanes() const { return _planes; }
+
+private:
+    /// plane id of each point
+    std::vector<int> _pointPlanes;
+    /// plane equations (a, b, c, d), 4 values per plane
+    std::vector<double> _planes;
+};
+
+/**
+ * @brief Computes a MVGPlaneSegmentation in a background thread, on a copy of the point cloud.
+ *
+ * The callback is called from the worker thread once the result is available: it should only
+ * schedule a call to takeResult on the thread owning the task.
+ */
+class MVGPlaneSegmentationTask
+{
+
+public:
+    MVGPlaneSegmentationTask();
+    ~MVGPlaneSegmentationTask();
+
+public:
+    void start(const MVGPointCloudStore& store, const MVGPlaneSegmentation::Options& options,
+               const std::function<void()>& onDone);
+    void cancel();
+    bool takeResult(MVGPlaneSegmentation& result);
+
+private:
+    void run(std::vector<double> x, std::vector<double> y, std::vector<double> z,
+             MVGPlaneSegmentation::Options options, std::function<void()> onDone);
+
+private:
+    std::thread _thread;
+    std::atomic<bool> _cancel;
+    std::mutex _mutex;
+    MVGPlaneSegmentation _result;
+    bool _hasResult;
+};
+
+} // namespace
@@ -4,6 +4,7 @@
 #include "meshroomMaya/core/MVGProject.hpp"
 #include "meshroomMaya/core/MVGGeometryUtil.hpp"
 #include "meshroomMaya/core/MVGPlaneKernel.hpp"
+#include "meshroomMaya/core/MVGIncrementalPlaneFitter.hpp"
 #include "meshroomMaya/maya/MVGMayaUtil.hpp"
 #include <maya/M3dView.h>
 #include <maya/MFnParticleSystem.h>
@@ -16,6 +17,7 @@
 #include <maya/MFnVectorArrayData.h>
 #include <maya/MPlug.h>
 #include <maya/MMatrix.h>
+#include <algorithm>
 #include <stdexcept>
 
 namespace meshroomMaya
@@ -24,6 +26,9 @@ namespace meshroomMaya
 namespace
 { // empty namespace
 
+/// part of the enclosed points a precomputed plane must hold to be used for projection
+static const double DOMINANT_PLANE_MIN_RATIO = 0.6;
+
 int isLeft(const MPoint& P0, const MPoint& P1, const MPoint& P2)
 {
     // isLeft(): tests if a point is Left|On|Right of an infinite line.
@@ -60,8 +65,73 @@ int wn_PnPoly(const MPoint& P, const MPointArray& V)
     return wn;
 }
 
+/**
+ * @param[out] enclosedItems : sorted store indexes of the items enclosed in the face
+ */
+void getEnclosedItems(M3dView& view, const MVGPointCloudStore& store,
+                      const MVGPointCloudItemList& items, MVGPointCloudIndex& itemsIndex,
+                      const MPointArray& faceCSPoints, std::vector<int>& enclosedItems)
+{
+    const MVGGeometryUtil::ViewTransform transform(view);
+    MPointArray closedVSPolygon(MVGGeometryUtil::cameraToViewSpace(transform, faceCSPoints));
+    closedVSPolygon.append(closedVSPolygon[0]); // add an extra point (to describe a closed shape)
+
+    // polygon bounding box
+    MPoint minVSPoint(closedVSPolygon[0]);
+    MPoint maxVSPoint(closedVSPolygon[0]);
+    for(int i = 1; i < closedVSPolygon.length(); ++i)
+    {
+        minVSPoint.x = std::min(minVSPoint.x, closedVSPolygon[i].x);
+        minVSPoint.y = std::min(minVSPoint.y, closedVSPolygon[i].y);
+        maxVSPoint.x = std::max(maxVSPoint.x, closedVSPolygon[i].x);
+        maxVSPoint.y = std::max(maxVSPoint.y, closedVSPolygon[i].y);
+    }
+
+    // (re)build the index if the view or the items changed, then only test the candidates
+    itemsIndex.update(transform, store, items);
+    std::vector<int> candidates;
+    itemsIndex.getCandidates(minVSPoint, maxVSPoint, candidates);
+    std::vector<int>::const_iterator it = candidates.begin();
+    for(; it != candidates.end(); ++it)
+    {
+        const MPoint vsPoint = itemsIndex.getViewPosition(*it);
+        if(vsPoint.x < minVSPoint.x || vsPoint.x > maxVSPoint.x || vsPoint.y < minVSPoint.y ||
+           vsPoint.y > maxVSPoint.y)
+            continue;
+        if(wn_PnPoly(vsPoint, closedVSPolygon) == 0)
+            continue;
+        enclosedItems.push_back(items.get()[*it]);
+    }
+    std::sort(enclosedItems.begin(), enclosedItems.end());
+}
+
+/**
+ * @param[out] enclosedWeights : number of cameras seeing each enclosed point, the longest
+ * tracks being the most accurately triangulated
+ */
+void getEnclosedPoints(const MVGPointCloudStore& store, const std::vector<int>& enclosedItems,
+                       MPointArray& enclosedWSPoints, std::vector<double>& enclosedWeights)
+{
+    const MVGVisibilityGraph& visibilityGraph = MVGCamera::getVisibilityGraph();
+    const int graphPointsCount = static_cast<int>(visibilityGraph.getPointsCount());
+    enclosedWSPoints.setLength(enclosedItems.size());
+    enclosedWeights.resize(enclosedItems.size());
+    for(size_t i = 0; i < enclosedItems.size(); ++i)
+    {
+        const int storeIndex = enclosedItems[i];
+        enclosedWSPoints[i] =
+            MPoint(store.getX(storeIndex), store.getY(storeIndex), store.getZ(storeIndex));
+        enclosedWeights[i] = storeIndex < graphPointsCount ?
+                                 visibilityGraph.getPointCameras(storeIndex).size() :
+                                 0.0;
+    }
+}
+
 } // empty namespace
 
+MVGPointCloudStore MVGPointCloud::_store;
+MVGPlaneSegmentation MVGPointCloud::_planeSegmentation;
+
 MVGPointCloud::MVGPointCloud(const std::string& name)
     : MVGNodeWrapper(name)
 {
@@ -119,17 +189,84 @@ MStatus MVGPointCloud::getItems(std::vector<MVGPointCloudItem>& items,
     return status;
 }
 
+/**
+ * Fill the point cloud store with the particle positions.
+ * Store indexes match the particle indexes.
+ */
+MStatus MVGPointCloud::loadStore() const
+{
+    MStatus status;
+    _store.clear();
+    _planeSegmentation.clear();
+    MFnParticleSystem fnParticle(_dagpath, &status);
+    CHECK_RETURN_STATUS(status)
+    MVectorArray positionArray;
+    fnParticle.position(positionArray);
+    _store.resize(positionArray.length());
+    for(int i = 0; i < positionArray.length(); ++i)
+        _store.setItem(i, i, positionArray[i].x, positionArray[i].y, positionArray[i].z);
+    return status;
+}
+
+// static
+const MVGPointCloudStore& MVGPointCloud::getStore()
+{
+    if(_store.empty())
+    {
+        MVGPointCloud cloud(MVGProject::_CLOUD);
+        if(cloud.isValid())
+            cloud.loadStore();
+    }
+    return _store;
+}
+
+/**
+ * Take ownership of an already filled store (the given one is left empty).
+ */
+// static
+void MVGPointCloud::setStore(MVGPointCloudStore& store)
+{
+    _store.swap(store);
+    store.clear();
+    _planeSegmentation.clear();
+}
+
+// static
+void MVGPointCloud::clearStore()
+{
+    _store.clear();
+    _planeSegmentation.clear();
+}
+
+/**
+ * Take ownership of the plane segmentation of the current store (the given one is left empty).
+ * It is ignored if it does not match the store size.
+ */
+// static
+void MVGPointCloud::setPlaneSegmentation(MVGPlaneSegmentation& segmentation)
+{
+    _planeSegmentation.clear();
+    if(segmentation.getPointsCount() == _store.size())
+        _planeSegmentation.swap(segmentation);
+    segmentation.clear();
+}
+
 /**
  *
  * @param[in] view
- * @param[in] visibleItems : pointcloud items visible for the current camera
+ * @param[in] visibleItems : store indexes of the pointcloud items visible for the current camera
+ * @param[in] visibleItemsIndex : view space index of visibleItems, rebuilt if out of date
  * @param[in] faceCSPoints : points describing the face in camera space coordinates
  * @param[out] faceWSPoints : faceCSPoints projected on computed plane in world space
  *coordinates
+ * @param[in] planeFitter : optional, enclosed items of the previous call, updated with the
+ *enclosed items of this one. Its plane is used unless the items are not planar enough.
  * @return
  */
-bool MVGPointCloud::projectPoints(M3dView& view, const std::vector<MVGPointCloudItem>& visibleItems,
-                                  const MPointArray& faceCSPoints, MPointArray& faceWSPoints)
+bool MVGPointCloud::projectPoints(M3dView& view, const MVGPointCloudItemList& visibleItems,
+                                  MVGPointCloudIndex& visibleItemsIndex,
+                                  const MPointArray& faceCSPoints, MPointArray& faceWSPoints,
+                                  MVGIncrementalPlaneFitter* planeFitter)
 {
     if(!isValid())
         return false;
@@ -138,26 +275,28 @@ bool MVGPointCloud::projectPoints(M3dView& view, const std::vector<MVGPointCloud
     if(visibleItems.size() < 3)
         return false;
 
-    MPointArray closedVSPolygon(MVGGeometryUtil::cameraToViewSpace(view, faceCSPoints));
-    closedVSPolygon.append(closedVSPolygon[0]); // add an extra point (to describe a closed shape)
-
     // get enclosed items in pointcloud
-    MPointArray enclosedWSPoints;
-    std::vector<MVGPointCloudItem>::const_iterator it = visibleItems.begin();
-    int windingNumber = 0;
-    for(; it != visibleItems.end(); ++it)
-    {
-        windingNumber =
-            wn_PnPoly(MVGGeometryUtil::worldToViewSpace(view, it->_position), closedVSPolygon);
-        if(windingNumber != 0)
-            enclosedWSPoints.append(it->_position);
-    }
-    if(enclosedWSPoints.length() < 3)
+    const MVGPointCloudStore& store = getStore();
+    std::vector<int> enclosedItems;
+    getEnclosedItems(view, store, visibleItems, visibleItemsIndex, faceCSPoints, enclosedItems);
+    if(planeFitter)
+        planeFitter->update(store, enclosedItems);
+    if(enclosedItems.size() < 3)
         return false;
 
-    // Compute plane
+    // Use the precomputed plane of most enclosed points, or compute one (robustly if the
+    // enclosed points are not planar enough)
     PlaneKernel::Model model;
-    MVGGeometryUtil::computePlane(enclosedWSPoints, model);
+    const bool hasPlane =
+        _planeSegmentation.getPointsCount() == store.size() &&
+        _planeSegmentation.getDominantPlane(enclosedItems, DOMINANT_PLANE_MIN_RATIO, model);
+    if(!hasPlane && (!planeFitter || !planeFitter->fitPlane(model)))
+    {
+        MPointArray enclosedWSPoints;
+        std::vector<double> enclosedWeights;
+        getEnclosedPoints(store, enclosedItems, enclosedWSPoints, enclosedWeights);
+        MVGGeometryUtil::computePlane(enclosedWSPoints, model, enclosedWeights);
+    }
     // Project points
     return MVGGeometryUtil::projectPointsOnPlane(view, faceCSPoints, model, faceWSPoints);
 }
@@ -165,18 +304,25 @@ bool MVGPointCloud::projectPoints(M3dView& view, const std::vector<MVGPointCloud
 /**
  *
  * @param[in] view
- * @param[in] visibleItems : pointcloud items visible for the current camera
+ * @param[in] visibleItems : store indexes of the pointcloud items visible for the current camera
+ * @param[in] visibleItemsIndex : view space index of visibleItems, rebuilt if out of date
  * @param[in] faceCSPoints : points describing the face in camera space coordinates
  * @param[in] constraintedWSPoints : points describing the line constraint in world space
  *coordinates
  * @param[in] mouseCSPoint : mouse camera space coordinates
  * @param[out] projectedWSMouse : mouseCSPoint projected on computed plane in world space
+ * @param[in] planeFitter : optional, enclosed items of the previous call, updated with the
+ *enclosed items of this one. Its plane is used unless the items are not planar enough.
  * @return
  */
-bool MVGPointCloud::projectPointsWithLineConstraint(
-    M3dView& view, const std::vector<MVGPointCloudItem>& visibleItems,
-    const MPointArray& faceCSPoints, const MPointArray& constraintedWSPoints,
-    const MPoint& mouseCSPoint, MPoint& projectedWSMouse)
+bool MVGPointCloud::projectPointsWithLineConstraint(M3dView& view,
+                                                    const MVGPointCloudItemList& visibleItems,
+                                                    MVGPointCloudIndex& visibleItemsIndex,
+                                                    const MPointArray& faceCSPoints,
+                                                    const MPointArray& constraintedWSPoints,
+                                                    const MPoint& mouseCSPoint,
+                                                    MPoint& projectedWSMouse,
+                                                    MVGIncrementalPlaneFitter* planeFitter)
 {
     if(!isValid())
         return false;
@@ -187,25 +333,26 @@ bool MVGPointCloud::projectPointsWithLineConstraint(
     if(constraintedWSPoints.length() < 2)
         return false;
 
-    MPointArray closedVSPolygon(MVGGeometryUtil::cameraToViewSpace(view, faceCSPoints));
-    closedVSPolygon.append(closedVSPolygon[0]); // add an extra point (to describe a closed shape)
-
     // get enclosed items in pointcloud
-    MPointArray enclosedWSPoints;
-    std::vector<MVGPointCloudItem>::const_iterator it = visibleItems.begin();
-    int windingNumber = 0;
-    for(; it != visibleItems.end(); ++it)
-    {
-        windingNumber =
-            wn_PnPoly(MVGGeometryUtil::worldToViewSpace(view, it->_position), closedVSPolygon);
-        if(windingNumber != 0)
-            enclosedWSPoints.append(it->_position);
-    }
-    if(enclosedWSPoints.length() < 3)
+    const MVGPointCloudStore& store = getStore();
+    std::vector<int> enclosedItems;
+    getEnclosedItems(view, store, visibleItems, visibleItemsIndex, faceCSPoints, enclosedItems);
+    if(planeFitter)
+        planeFitter->update(store, enclosedItems);
+    if(enclosedItems.size() < 3)
         return false;
 
     LineConstrainedPlaneKernel::Model model;
-    MVGGeometryUtil::computePlaneWithLineConstraint(enclosedWSPoints, constraintedWSPoints, model);
+    if(!planeFitter ||
+       !planeFitter->fitPlaneWithLineConstraint(TO_VEC3(constraintedWSPoints[0]),
+                                                TO_VEC3(constraintedWSPoints[1]), model))
+    {
+        MPointArray enclosedWSPoints;
+        std::vector<double> enclosedWeights;
+        getEnclosedPoints(store, enclosedItems, enclosedWSPoints, enclosedWeights);
+        MVGGeometryUtil::computePlaneWithLineConstraint(enclosedWSPoints, constraintedWSPoints,
+                                                        model, enclosedWeights);
+    }
 
     // Project the mouse point
     return MVGGeometryUtil::projectPointOnPlane(view, mouseCSPoint, model, projectedWSMouse);
@@ -227,6 +374,15 @@ MStatus MVGPointCloud::setOpacity(const MIntArray &indices, double value)
     return setOpacityPPAttribute(array);
 }
 
+/**
+ * Set the opacity of every particle in a single write.
+ * @param[in] values : opacity of each particle
+ */
+MStatus MVGPointCloud::setOpacity(MDoubleArray& values)
+{
+    return setOpacityPPAttribute(values);
+}
+
 MStatus MVGPointCloud::getOpacityPP(MDoubleArray& values)
 {
     MStatus status;
@@ -2,6 +2,9 @@
 
 #include "meshroomMaya/core/MVGNodeWrapper.hpp"
 #include "meshroomMaya/core/MVGPointCloudItem.hpp"
+#include "meshroomMaya/core/MVGPointCloudIndex.hpp"
+#include "meshroomMaya/core/MVGPointCloudStore.hpp"
+#include "meshroomMaya/core/MVGPlaneSegmentation.hpp"
 #include <vector>
 
 class MIntArray;
@@ -13,6 +16,7 @@ namespace meshroomMaya
 
 class MVGCamera;
 class MVGPointCloudItem;
+class MVGIncrementalPlaneFitter;
 
 class MVGPointCloud : public MVGNodeWrapper
 {
@@ -28,16 +32,27 @@ public:
 public:
     MStatus getItems(std::vector<MVGPointCloudItem>& items) const;
     MStatus getItems(std::vector<MVGPointCloudItem>& items, const MIntArray& indexes) const;
-    bool projectPoints(M3dView& view, const std::vector<MVGPointCloudItem>& visibleItems,
-                       const MPointArray& faceCSPoints, MPointArray& faceWSPoints);
+    bool projectPoints(M3dView& view, const MVGPointCloudItemList& visibleItems,
+                       MVGPointCloudIndex& visibleItemsIndex, const MPointArray& faceCSPoints,
+                       MPointArray& faceWSPoints, MVGIncrementalPlaneFitter* planeFitter = NULL);
     bool projectPointsWithLineConstraint(M3dView& view,
-                                         const std::vector<MVGPointCloudItem>& visibleItems,
+                                         const MVGPointCloudItemList& visibleItems,
+                                         MVGPointCloudIndex& visibleItemsIndex,
                                          const MPointArray& faceCSPoints,
                                          const MPointArray& constraintedWSPoints,
-                                         const MPoint& mouseCSPoint, MPoint& projectedWSMouse);
+                                         const MPoint& mouseCSPoint, MPoint& projectedWSMouse,
+                                         MVGIncrementalPlaneFitter* planeFitter = NULL);
+
+    MStatus loadStore() const;
+    static const MVGPointCloudStore& getStore();
+    static void setStore(MVGPointCloudStore& store);
+    static void clearStore();
+    static const MVGPlaneSegmentation& getPlaneSegmentation() { return _planeSegmentation; }
+    static void setPlaneSegmentation(MVGPlaneSegmentation& segmentation);
 
     MStatus setOpacity(double value);
     MStatus setOpacity(const MIntArray& indices, double value);
+    MStatus setOpacity(MDoubleArray& values);
 
 protected:
     MStatus getOpacityPP(MDoubleArray& values);
@@ -45,6 +60,12 @@ protected:
 private:
     MStatus ensureOpacityPPAttribute();
 
+private:
+    /// point cloud items of the current project
+    static MVGPointCloudStore _store;
+    /// planes of the store items, empty until computed
+    static MVGPlaneSegmentation _planeSegmentation;
+
 };
 
 } // namespace
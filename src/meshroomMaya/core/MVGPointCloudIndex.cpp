@@ -0,0 +1,164 @@
+#include "meshroomMaya/core/MVGPointCloudIndex.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+// average number of items per cell
+static const double ITEMS_PER_CELL = 4.0;
+// grid resolution limit (per axis)
+static const int MAX_CELLS_PER_AXIS = 1024;
+
+} // empty namespace
+
+MVGPointCloudIndex::MVGPointCloudIndex()
+    : _store(NULL)
+    , _storeRevision(0)
+    , _items(NULL)
+    , _itemsRevision(0)
+    , _itemsCount(0)
+    , _minX(0.0)
+    , _minY(0.0)
+    , _cellSize(1.0)
+    , _nbCellsX(0)
+    , _nbCellsY(0)
+{
+}
+
+void MVGPointCloudIndex::clear()
+{
+    _viewTransform = MVGGeometryUtil::ViewTransform();
+    _store = NULL;
+    _storeRevision = 0;
+    _items = NULL;
+    _itemsRevision = 0;
+    _itemsCount = 0;
+    _viewX.clear();
+    _viewY.clear();
+    _nbCellsX = 0;
+    _nbCellsY = 0;
+    _cellStart.clear();
+    _cellItems.clear();
+}
+
+bool MVGPointCloudIndex::isUpToDate(const MVGGeometryUtil::ViewTransform& transform,
+                                    const MVGPointCloudStore& store,
+                                    const MVGPointCloudItemList& items) const
+{
+    if(_nbCellsX == 0 || _nbCellsY == 0)
+        return false;
+    if(&store != _store || store.getRevision() != _storeRevision)
+        return false;
+    if(&items != _items || items.getRevision() != _itemsRevision)
+        return false;
+    return transform == _viewTransform;
+}
+
+void MVGPointCloudIndex::build(const MVGGeometryUtil::ViewTransform& transform,
+                               const MVGPointCloudStore& store,
+                               const MVGPointCloudItemList& items)
+{
+    clear();
+    if(items.size() == 0)
+        return;
+    _viewTransform = transform;
+    _store = &store;
+    _storeRevision = store.getRevision();
+    _items = &items;
+    _itemsRevision = items.getRevision();
+    _itemsCount = items.size();
+
+    // project items in view space
+    _viewX.resize(_itemsCount);
+    _viewY.resize(_itemsCount);
+    MVGGeometryUtil::worldToViewSpace(transform, store.getXData(), store.getYData(),
+                                      store.getZData(), items.get().data(), _itemsCount,
+                                      _viewX.data(), _viewY.data());
+    _minX = *std::min_element(_viewX.begin(), _viewX.end());
+    _minY = *std::min_element(_viewY.begin(), _viewY.end());
+    const double maxX = *std::max_element(_viewX.begin(), _viewX.end());
+    const double maxY = *std::max_element(_viewY.begin(), _viewY.end());
+
+    // choose a cell size giving a few items per cell on average
+    const double extentX = std::max(maxX - _minX, 1.0);
+    const double extentY = std::max(maxY - _minY, 1.0);
+    _cellSize = std::max(1.0, std::sqrt(extentX * extentY * ITEMS_PER_CELL / _itemsCount));
+    _cellSize = std::max(_cellSize, std::max(extentX, extentY) / MAX_CELLS_PER_AXIS);
+    _nbCellsX = static_cast<int>(extentX / _cellSize) + 1;
+    _nbCellsY = static_cast<int>(extentY / _cellSize) + 1;
+
+    // counting sort of the items by cell
+    std::vector<int> itemCell(_itemsCount);
+    _cellStart.assign(_nbCellsX * _nbCellsY + 1, 0);
+    for(size_t i = 0; i < _itemsCount; ++i)
+    {
+        itemCell[i] = cellY(_viewY[i]) * _nbCellsX + cellX(_viewX[i]);
+        ++_cellStart[itemCell[i] + 1];
+    }
+    for(size_t c = 1; c < _cellStart.size(); ++c)
+        _cellStart[c] += _cellStart[c - 1];
+    std::vector<int> fill(_cellStart.begin(), _cellStart.end() - 1);
+    _cellItems.resize(_itemsCount);
+    for(size_t i = 0; i < _itemsCount; ++i)
+        _cellItems[fill[itemCell[i]]++] = i;
+}
+
+void MVGPointCloudIndex::update(const MVGGeometryUtil::ViewTransform& transform,
+                                const MVGPointCloudStore& store,
+                                const MVGPointCloudItemList& items)
+{
+    if(!isUpToDate(transform, store, items))
+        build(transform, store, items);
+}
+
+/**
+ * @param[in] minVSPoint : bounding box lower corner in view space coordinates
+ * @param[in] maxVSPoint : bounding box upper corner in view space coordinates
+ * @param[out] candidates : indices of the items lying in the cells overlapping the bounding box
+ */
+void MVGPointCloudIndex::getCandidates(const MPoint& minVSPoint, const MPoint& maxVSPoint,
+                                       std::vector<int>& candidates) const
+{
+    candidates.clear();
+    if(_nbCellsX == 0 || _nbCellsY == 0)
+        return;
+    const int minCellX = cellX(minVSPoint.x);
+    const int maxCellX = cellX(maxVSPoint.x);
+    const int minCellY = cellY(minVSPoint.y);
+    const int maxCellY = cellY(maxVSPoint.y);
+    for(int y = minCellY; y <= maxCellY; ++y)
+    {
+        const int rowStart = y * _nbCellsX;
+        candidates.insert(candidates.end(), _cellItems.begin() + _cellStart[rowStart + minCellX],
+                          _cellItems.begin() + _cellStart[rowStart + maxCellX + 1]);
+    }
+}
+
+MPoint MVGPointCloudIndex::getViewPosition(const int itemIndex) const
+{
+    return MPoint(_viewX[itemIndex], _viewY[itemIndex], 0.0);
+}
+
+int MVGPointCloudIndex::cellX(const double x) const
+{
+    // clamp before the cast to stay in the int range, non finite values going to the first cell
+    const double cell = std::floor((x - _minX) / _cellSize);
+    if(!(cell > 0.0))
+        return 0;
+    return static_cast<int>(std::min(cell, static_cast<double>(_nbCellsX - 1)));
+}
+
+int MVGPointCloudIndex::cellY(const double y) const
+{
+    // clamp before the cast to stay in the int range, non finite values going to the first cell
+    const double cell = std::floor((y - _minY) / _cellSize);
+    if(!(cell > 0.0))
+        return 0;
+    return static_cast<int>(std::min(cell, static_cast<double>(_nbCellsY - 1)));
+}
+
+} // namespace
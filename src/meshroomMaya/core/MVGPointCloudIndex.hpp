@@ -0,0 +1,98 @@
+#pragma once
+
+#include "meshroomMaya/core/MVGPointCloudStore.hpp"
+#include "meshroomMaya/core/MVGGeometryUtil.hpp"
+#include <maya/MPoint.h>
+#include <vector>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Point cloud store indexes of a subset of the items (e.g. the items visible by a camera).
+ *
+ * The revision is incremented each time the list may be modified, so that an index built on
+ * the list detects it even if the vector is refilled in place.
+ */
+class MVGPointCloudItemList
+{
+
+public:
+    MVGPointCloudItemList()
+        : _revision(0)
+    {
+    }
+
+public:
+    std::vector<int>& edit()
+    {
+        ++_revision;
+        return _items;
+    }
+    const std::vector<int>& get() const { return _items; }
+    size_t size() const { return _items.size(); }
+    unsigned int getRevision() const { return _revision; }
+
+private:
+    std::vector<int> _items;
+    /// incremented each time the list is given for modification
+    unsigned int _revision;
+};
+
+/**
+ * @brief Uniform 2D grid over the view space projections of a subset of the point cloud store.
+ *
+ * Items are projected once when the index is built and bucketed into fixed size cells.
+ * Enclosure queries then only have to visit the cells overlapping the query bounding box.
+ * The index keeps track of the view transform it has been built for and is rebuilt when the
+ * view, the store content or the item list change.
+ * Item indexes returned by queries are positions in the item list the index has been built with.
+ */
+class MVGPointCloudIndex
+{
+
+public:
+    MVGPointCloudIndex();
+
+public:
+    void clear();
+    bool isUpToDate(const MVGGeometryUtil::ViewTransform& transform,
+                    const MVGPointCloudStore& store, const MVGPointCloudItemList& items) const;
+    void build(const MVGGeometryUtil::ViewTransform& transform, const MVGPointCloudStore& store,
+               const MVGPointCloudItemList& items);
+    void update(const MVGGeometryUtil::ViewTransform& transform, const MVGPointCloudStore& store,
+                const MVGPointCloudItemList& items);
+
+public:
+    void getCandidates(const MPoint& minVSPoint, const MPoint& maxVSPoint,
+                       std::vector<int>& candidates) const;
+    MPoint getViewPosition(const int itemIndex) const;
+    size_t size() const { return _itemsCount; }
+
+private:
+    int cellX(const double x) const;
+    int cellY(const double y) const;
+
+private:
+    /// view, store and item list this index has been built for
+    MVGGeometryUtil::ViewTransform _viewTransform;
+    const MVGPointCloudStore* _store;
+    unsigned int _storeRevision;
+    const MVGPointCloudItemList* _items;
+    unsigned int _itemsRevision;
+    size_t _itemsCount;
+    /// projected view space coordinates, one entry per item
+    std::vector<double> _viewX;
+    std::vector<double> _viewY;
+    /// grid description
+    double _minX;
+    double _minY;
+    double _cellSize;
+    int _nbCellsX;
+    int _nbCellsY;
+    /// item indices sorted by cell, _cellStart[c] to _cellStart[c+1] being the range of cell c
+    std::vector<int> _cellStart;
+    std::vector<int> _cellItems;
+};
+
+} // namespace
@@ -0,0 +1,75 @@
+#include "meshroomMaya/core/MVGPointCloudStore.hpp"
+
+namespace meshroomMaya
+{
+
+MVGPointCloudStore::MVGPointCloudStore()
+    : _revision(0)
+{
+}
+
+void MVGPointCloudStore::clear()
+{
+    _x.clear();
+    _y.clear();
+    _z.clear();
+    _ids.clear();
+    _weights.clear();
+    ++_revision;
+}
+
+/**
+ * Exchange contents, both revisions being incremented.
+ */
+void MVGPointCloudStore::swap(MVGPointCloudStore& other)
+{
+    _x.swap(other._x);
+    _y.swap(other._y);
+    _z.swap(other._z);
+    _ids.swap(other._ids);
+    _weights.swap(other._weights);
+    ++_revision;
+    ++other._revision;
+}
+
+void MVGPointCloudStore::resize(const size_t count)
+{
+    _x.resize(count);
+    _y.resize(count);
+    _z.resize(count);
+    _ids.resize(count);
+    _weights.resize(count);
+    ++_revision;
+}
+
+void MVGPointCloudStore::setItem(const size_t index, const int id, const double x, const double y,
+                                 const double z, const float weight)
+{
+    _ids[index] = id;
+    _x[index] = x;
+    _y[index] = y;
+    _z[index] = z;
+    _weights[index] = weight;
+}
+
+/**
+ * Take ownership of the given coordinates (vectors are left empty), ids being the indexes.
+ * @return false and leave the store empty if coordinate arrays do not have the same size
+ */
+bool MVGPointCloudStore::assign(std::vector<double>& x, std::vector<double>& y,
+                                std::vector<double>& z)
+{
+    clear();
+    if(x.size() != y.size() || x.size() != z.size())
+        return false;
+    _x.swap(x);
+    _y.swap(y);
+    _z.swap(z);
+    _ids.resize(_x.size());
+    for(size_t i = 0; i < _ids.size(); ++i)
+        _ids[i] = i;
+    _weights.assign(_x.size(), 1.f);
+    return true;
+}
+
+} // namespace
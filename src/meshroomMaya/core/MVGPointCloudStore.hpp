@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Contiguous (structure of arrays) storage of the point cloud items.
+ *
+ * Filled once per project load from the Maya particle system (see MVGPointCloud::loadStore),
+ * then accessed by index by the cameras and the manipulators instead of copying
+ * MVGPointCloudItem objects. This class does not depend on Maya.
+ */
+class MVGPointCloudStore
+{
+
+public:
+    MVGPointCloudStore();
+
+public:
+    void clear();
+    void swap(MVGPointCloudStore& other);
+    void resize(const size_t count);
+    void setItem(const size_t index, const int id, const double x, const double y, const double z,
+                 const float weight = 1.f);
+    bool assign(std::vector<double>& x, std::vector<double>& y, std::vector<double>& z);
+
+public:
+    size_t size() const { return _ids.size(); }
+    bool empty() const { return _ids.empty(); }
+    unsigned int getRevision() const { return _revision; }
+    int getId(const size_t index) const { return _ids[index]; }
+    double getX(const size_t index) const { return _x[index]; }
+    double getY(const size_t index) const { return _y[index]; }
+    double getZ(const size_t index) const { return _z[index]; }
+    float getWeight(const size_t index) const { return _weights[index]; }
+    const double* getXData() const { return _x.data(); }
+    const double* getYData() const { return _y.data(); }
+    const double* getZData() const { return _z.data(); }
+
+private:
+    std::vector<double> _x;
+    std::vector<double> _y;
+    std::vector<double> _z;
+    std::vector<int> _ids;
+    std::vector<float> _weights;
+    /// incremented each time the content is reset, used to detect stale references
+    unsigned int _revision;
+};
+
+} // namespace
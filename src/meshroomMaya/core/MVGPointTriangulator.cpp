@@ -0,0 +1,164 @@
+#include "meshroomMaya/core/MVGPointTriangulator.hpp"
+#include <aliceVision/multiview/triangulation/Triangulation.hpp>
+#include <algorithm>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+/// relative change of the reprojection error or of the point under which the refinement has
+/// converged
+const double CONVERGENCE_TOLERANCE = 1e-10;
+/// damping over which no step can decrease the reprojection error anymore
+const double MAX_DAMPING = 1e10;
+
+/**
+ * @param[out] residuals : reprojection error in each view, 2 values per view
+ * @return false if the point is behind one of the cameras
+ */
+bool computeResiduals(const std::vector<aliceVision::Mat34>& projections,
+                      const aliceVision::Mat2X& imagePoints, const aliceVision::Vec3& point,
+                      aliceVision::Vec& residuals)
+{
+    residuals.resize(2 * projections.size());
+    bool inFront = true;
+    for(size_t i = 0; i < projections.size(); ++i)
+    {
+        const aliceVision::Vec3 projected = projections[i] * point.homogeneous();
+        inFront &= (projected(2) > 0.0);
+        residuals.segment<2>(2 * i) = projected.hnormalized() - imagePoints.col(i);
+    }
+    return inFront;
+}
+
+} // empty namespace
+
+MVGPointTriangulator::MVGPointTriangulator()
+    : _hasPreviousPoint(false)
+    , _previousPoint(aliceVision::Vec3::Zero())
+    , _maxIterations(10)
+{
+}
+
+void MVGPointTriangulator::clear()
+{
+    _hasPreviousPoint = false;
+}
+
+/**
+ * Starts from the previous result if any, or from the algebraic solution if the previous result
+ * is behind a camera or does not converge within the iterations limit.
+ *
+ * @param[in] projections : projection matrices (image space) of the views
+ * @param[in] imagePoints : point in each view (image space)
+ * @param[out] point : triangulated point
+ * @param[out] residuals : reprojection error of the point in each view, in pixels
+ * @return false if there are less than 2 views, or if the point is at infinity
+ */
+bool MVGPointTriangulator::triangulate(const std::vector<aliceVision::Mat34>& projections,
+                                       const aliceVision::Mat2X& imagePoints,
+                                       aliceVision::Vec3& point, std::vector<double>* residuals)
+{
+    const size_t viewCount = projections.size();
+    if(viewCount < 2 || static_cast<size_t>(imagePoints.cols()) != viewCount)
+        return false;
+
+    point = _previousPoint;
+    if(!_hasPreviousPoint || !refine(projections, imagePoints, point))
+    {
+        aliceVision::Vec4 algebraicPoint;
+        aliceVision::TriangulateNViewAlgebraic(imagePoints, projections, &algebraicPoint);
+        if(algebraicPoint(3) == 0.0)
+            return false;
+        point = algebraicPoint.hnormalized();
+        refine(projections, imagePoints, point);
+    }
+    _previousPoint = point;
+    _hasPreviousPoint = true;
+
+    if(residuals)
+    {
+        aliceVision::Vec viewResiduals;
+        computeResiduals(projections, imagePoints, point, viewResiduals);
+        residuals->resize(viewCount);
+        for(size_t i = 0; i < viewCount; ++i)
+            (*residuals)[i] = viewResiduals.segment<2>(2 * i).norm();
+    }
+    return true;
+}
+
+/**
+ * Levenberg-Marquardt minimization of the squared reprojection errors. Each iteration solves a
+ * 3x3 system, steps increasing the error or moving the point behind a camera are rejected.
+ *
+ * @param[in,out] point : starting point, refined point
+ * @return false if the starting point is behind a camera, or if the refinement did not converge
+ * within the iterations limit
+ */
+bool MVGPointTriangulator::refine(const std::vector<aliceVision::Mat34>& projections,
+                                  const aliceVision::Mat2X& imagePoints,
+                                  aliceVision::Vec3& point) const
+{
+    aliceVision::Vec residuals;
+    if(!computeResiduals(projections, imagePoints, point, residuals))
+        return false;
+    double cost = residuals.squaredNorm();
+    double damping = 1e-3;
+    bool updateNormalEquations = true;
+    aliceVision::Mat3 JtJ;
+    aliceVision::Vec3 Jtr;
+    aliceVision::Vec candidateResiduals;
+    for(size_t iteration = 0; iteration < _maxIterations; ++iteration)
+    {
+        if(cost == 0.0)
+            return true;
+        if(updateNormalEquations)
+        {
+            JtJ.setZero();
+            Jtr.setZero();
+            for(size_t i = 0; i < projections.size(); ++i)
+            {
+                const aliceVision::Mat34& P = projections[i];
+                const aliceVision::Vec3 projected = P * point.homogeneous();
+                const aliceVision::Vec2 imagePoint = projected.hnormalized();
+                // derivatives of the projected point with respect to the 3D point
+                Eigen::Matrix<double, 2, 3> J;
+                J.row(0) = P.block<1, 3>(0, 0) - imagePoint(0) * P.block<1, 3>(2, 0);
+                J.row(1) = P.block<1, 3>(1, 0) - imagePoint(1) * P.block<1, 3>(2, 0);
+                J /= projected(2);
+                JtJ += J.transpose() * J;
+                Jtr += J.transpose() * residuals.segment<2>(2 * i);
+            }
+            updateNormalEquations = false;
+        }
+        aliceVision::Mat3 A = JtJ;
+        A.diagonal() *= 1.0 + damping;
+        const aliceVision::Vec3 step = A.ldlt().solve(-Jtr);
+        if(step.norm() <= CONVERGENCE_TOLERANCE * point.norm())
+            return true;
+        const aliceVision::Vec3 candidate = point + step;
+        const bool inFront = computeResiduals(projections, imagePoints, candidate,
+                                              candidateResiduals);
+        const double candidateCost = candidateResiduals.squaredNorm();
+        if(!inFront || !(candidateCost < cost))
+        {
+            damping *= 10.0;
+            if(damping > MAX_DAMPING)
+                return true;
+            continue;
+        }
+        const double decrease = cost - candidateCost;
+        point = candidate;
+        residuals.swap(candidateResiduals);
+        cost = candidateCost;
+        damping = std::max(damping / 10.0, 1e-12);
+        updateNormalEquations = true;
+        if(decrease <= CONVERGENCE_TOLERANCE * cost)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "meshroomMaya/core/MVGEigen.hpp"
+#include <vector>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief N-view triangulation minimizing the reprojection error.
+ *
+ * The algebraic solution only minimizes an algebraic distance, which is biased as soon as the
+ * views are far from each other or the clicked points are noisy. It is refined here by a few
+ * Levenberg-Marquardt iterations on the image space reprojection error.
+ * When triangulating the same point several times in a row (mouse drag), the previous result is
+ * used as the starting point instead of the algebraic solution. The number of iterations is
+ * bounded to keep the cost of each call predictable.
+ * This class does not depend on Maya.
+ */
+class MVGPointTriangulator
+{
+
+public:
+    MVGPointTriangulator();
+
+public:
+    void clear();
+    bool triangulate(const std::vector<aliceVision::Mat34>& projections,
+                     const aliceVision::Mat2X& imagePoints, aliceVision::Vec3& point,
+                     std::vector<double>* residuals = NULL);
+
+public:
+    size_t getMaxIterations() const { return _maxIterations; }
+    void setMaxIterations(const size_t iterations) { _maxIterations = iterations; }
+
+private:
+    bool refine(const std::vector<aliceVision::Mat34>& projections,
+                const aliceVision::Mat2X& imagePoints, aliceVision::Vec3& point) const;
+
+private:
+    /// result of the previous call, used as starting point of the next one
+    bool _hasPreviousPoint;
+    aliceVision::Vec3 _previousPoint;
+    size_t _maxIterations;
+};
+
+} // namespace
@@ -19,10 +19,55 @@
 #include <maya/MItDependencyNodes.h>
 #include <maya/MFnSet.h>
 #include <algorithm>
+#include <cstdlib>
 
 namespace
 { // empty namespace
 
+// default image cache budget, in megabytes
+static const size_t DEFAULT_IMAGE_CACHE_SIZE_MB = 512;
+// estimated memory used by an image plane of unknown size (4K RGBA)
+static const size_t DEFAULT_IMAGE_BYTES = 4096 * 3072 * 4;
+
+/**
+ * @return the image cache budget in bytes, from the MESHROOMMAYA_IMAGE_CACHE_SIZE_MB environment
+ * variable if it holds a positive number of megabytes
+ */
+size_t getImageCacheBudgetFromEnvironment()
+{
+    size_t sizeMB = DEFAULT_IMAGE_CACHE_SIZE_MB;
+    const char* env = std::getenv("MESHROOMMAYA_IMAGE_CACHE_SIZE_MB");
+    if(env)
+    {
+        char* end = NULL;
+        const unsigned long value = std::strtoul(env, &end, 10);
+        if(end != env && *end == '\0' && value > 0)
+            sizeMB = value;
+        else
+            LOG_WARNING("Invalid MESHROOMMAYA_IMAGE_CACHE_SIZE_MB \""
+                        << env << "\", using " << DEFAULT_IMAGE_CACHE_SIZE_MB << " MB")
+    }
+    return sizeMB * 1024 * 1024;
+}
+
+/**
+ * @return the estimated memory used by the image plane of the camera, as a RGBA 8 bits image
+ */
+size_t getImageBytes(const meshroomMaya::MVGCamera& camera)
+{
+    const std::pair<double, double> imageSize = camera.getImageSize();
+    if(imageSize.first <= 0 || imageSize.second <= 0)
+        return DEFAULT_IMAGE_BYTES;
+    return static_cast<size_t>(imageSize.first) * static_cast<size_t>(imageSize.second) * 4;
+}
+
+void unloadImagePlanes(const std::vector<std::string>& cameraNames)
+{
+    for(std::vector<std::string>::const_iterator it = cameraNames.begin();
+        it != cameraNames.end(); ++it)
+        meshroomMaya::MVGCamera(*it).unloadImagePlane();
+}
+
 void lockNode(MObject obj)
 {
     if(obj.apiType() != MFn::kTransform)
@@ -77,7 +122,8 @@ std::string MVGProject::_CAMERASET_PREFIX = "mvgCamset_";
 
 // Image cache
 // List of camera by name or dagpath according to uniqueness
-std::list<std::string> MVGProject::_cachedImagePlanes;
+MVGImageCache MVGProject::_imageCache(DEFAULT_IMAGE_CACHE_SIZE_MB * 1024 * 1024);
+unsigned int MVGProject::_imagePrefetchGeneration = 0;
 std::map<std::string, std::string> MVGProject::_lastLoadedCameraByView;
 
 MVGProject::MVGProject(const std::string& name)
@@ -313,24 +359,46 @@ void MVGProject::lockProject() const
     lockNode(cloudGroup);
 }
 
-void MVGProject::pushImageInCache(const std::string& cameraName)
+/**
+ * @param cameraName camera whose image is kept in memory
+ * @param prefetched the image has not been displayed yet: it is inserted as the least recently
+ * used one, so that it does not evict displayed images
+ */
+void MVGProject::pushImageInCache(const std::string& cameraName, const bool prefetched)
 {
     if(cameraName.empty())
         return;
 
-    std::list<std::string>::iterator camera =
-        std::find(_cachedImagePlanes.begin(), _cachedImagePlanes.end(), cameraName);
-    if(camera != _cachedImagePlanes.end()) // Camera is already in the list
+    if(_imageCache.contains(cameraName)) // Camera is already in the cache
         return;
 
-    if(_cachedImagePlanes.size() == IMAGE_CACHE_SIZE)
-    {
-        std::string frontCamera = _cachedImagePlanes.front();
-        MVGCamera camera(frontCamera);
-        camera.unloadImagePlane();
-        _cachedImagePlanes.pop_front();
-    }
-    _cachedImagePlanes.push_back(cameraName);
+    std::vector<std::string> evicted;
+    _imageCache.insert(cameraName, getImageBytes(MVGCamera(cameraName)), evicted, prefetched);
+    unloadImagePlanes(evicted);
+}
+
+/**
+ * Change the memory budget of the image cache, unloading the least recently used images that
+ * do not fit anymore.
+ * @param bytes maximum memory used by the cached images
+ */
+// static
+void MVGProject::setImageCacheBudget(const size_t bytes)
+{
+    std::vector<std::string> evicted;
+    _imageCache.setBudget(bytes, evicted);
+    unloadImagePlanes(evicted);
+}
+
+/**
+ * Apply the budget given by the MESHROOMMAYA_IMAGE_CACHE_SIZE_MB environment variable.
+ * Called on plugin load rather than at static initialization, so that an invalid value can be
+ * reported in Maya.
+ */
+// static
+void MVGProject::initImageCacheBudget()
+{
+    setImageCacheBudget(getImageCacheBudgetFromEnvironment());
 }
 
 const std::string MVGProject::getLastLoadedCameraInView(const std::string& viewName) const
@@ -348,6 +416,17 @@ void MVGProject::setLastLoadedCameraInView(const std::string& viewName,
     _lastLoadedCameraByView[viewName] = cameraName;
 }
 
+bool MVGProject::isCameraLoadedInView(const std::string& cameraName) const
+{
+    std::map<std::string, std::string>::const_iterator it = _lastLoadedCameraByView.begin();
+    for(; it != _lastLoadedCameraByView.end(); ++it)
+    {
+        if(it->second == cameraName)
+            return true;
+    }
+    return false;
+}
+
 /**
  * Update the image cache :
  *     - If current camera is in cache : remove it
@@ -358,11 +437,9 @@ void MVGProject::setLastLoadedCameraInView(const std::string& viewName,
 void MVGProject::updateImageCache(const std::string& newCameraName,
                                   const std::string& oldCameraName)
 {
-    // If new camera is in cache remove from cacheList
-    std::list<std::string>::iterator cameraIt =
-        std::find(_cachedImagePlanes.begin(), _cachedImagePlanes.end(), newCameraName);
-    if(cameraIt != _cachedImagePlanes.end())
-        _cachedImagePlanes.remove(newCameraName);
+    // If new camera is in cache (hit), remove it: its image is now displayed
+    if(_imageCache.touch(newCameraName))
+        _imageCache.remove(newCameraName);
 
     if(oldCameraName != newCameraName)
         pushImageInCache(oldCameraName);
@@ -373,7 +450,12 @@ void MVGProject::updateImageCache(const std::string& newCameraName,
  */
 void MVGProject::clearImageCache()
 {
-    _cachedImagePlanes.clear();
+    if(_imageCache.getHits() + _imageCache.getMisses() > 0)
+        LOG_INFO("Image cache: " << _imageCache.getHits() << " hits, "
+                                 << _imageCache.getMisses() << " misses, "
+                                 << _imageCache.getEvictions() << " evictions")
+    _imageCache.clear();
+    _imageCache.resetCounters();
 }
 
 /**
@@ -392,4 +474,35 @@ void MVGProject::pushLoadCurrentImagePlaneCommand(const std::string& panelName)
     CHECK_RETURN(status)
 }
 
+/**
+ * Invalidate the prefetches already queued.
+ * @return generation of the prefetches queued from now on
+ */
+unsigned int MVGProject::startImagePrefetch()
+{
+    return ++_imagePrefetchGeneration;
+}
+
+bool MVGProject::isImagePrefetchCurrent(const unsigned int generation) const
+{
+    return generation == _imagePrefetchGeneration;
+}
+
+/**
+ * Create a command to load the image plane of a camera that is likely to be displayed next.
+ * Push the command to the idle queue, after the load of the current image planes.
+ * @param cameraName camera whose image will be kept in the image cache
+ * @param generation prefetch generation, the command does nothing once it is outdated
+ */
+void MVGProject::pushPrefetchImagePlaneCommand(const std::string& cameraName,
+                                               const unsigned int generation) const
+{
+    MStatus status;
+    MString cmd;
+    cmd.format("MVGImagePlaneCmd -camera \"^1s\" -prefetch -generation ^2s", cameraName.c_str(),
+               MString() + generation);
+    status = MGlobal::executeCommandOnIdle(cmd);
+    CHECK_RETURN(status)
+}
+
 } // namespace
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "meshroomMaya/core/MVGNodeWrapper.hpp"
+#include "meshroomMaya/core/MVGImageCache.hpp"
 #include "maya/MColor.h"
 #include <maya/MGlobal.h>
 #include <vector>
@@ -10,7 +11,6 @@
 
 namespace meshroomMaya
 {
-#define IMAGE_CACHE_SIZE 3
 
 class MVGCamera;
 class MVGPointCloud;
@@ -47,10 +47,17 @@ public:
     // Image "cache"
     const std::string getLastLoadedCameraInView(const std::string& viewName) const;
     void setLastLoadedCameraInView(const std::string& viewName, const std::string& cameraName);
+    bool isCameraLoadedInView(const std::string& cameraName) const;
     void pushLoadCurrentImagePlaneCommand(const std::string& panelName) const;
-    void pushImageInCache(const std::string& cameraName);
+    unsigned int startImagePrefetch();
+    bool isImagePrefetchCurrent(const unsigned int generation) const;
+    void pushPrefetchImagePlaneCommand(const std::string& cameraName,
+                                       const unsigned int generation) const;
+    void pushImageInCache(const std::string& cameraName, const bool prefetched = false);
     void updateImageCache(const std::string& newCameraName, const std::string& oldCameraName);
-    const std::list<std::string>& getImageCache() { return _cachedImagePlanes; };
+    const MVGImageCache& getImageCache() const { return _imageCache; }
+    static void setImageCacheBudget(const size_t bytes);
+    static void initImageCacheBudget();
     void clearImageCache();
 
 public:
@@ -68,15 +75,19 @@ public:
     static MString _MVG_PROJECTPATH;
     static std::string _CAMERASET_PREFIX;
 
-    /// FIFO queue indicating the list of images/cameras keept in memory
-    /// Cameras corresponding to current images seen in panels are not stored in this list.
-    static std::list<std::string> _cachedImagePlanes;
+    /// LRU set of the images/cameras keept in memory, bounded by a memory budget
+    /// (MESHROOMMAYA_IMAGE_CACHE_SIZE_MB environment variable, 512MB by default).
+    /// Cameras corresponding to current images seen in panels are not stored in this cache.
+    static MVGImageCache _imageCache;
     /// Stores the camera name of the last image plane loaded in each view.
     /// The user can change the camera of the view faster than what Maya is
     /// able to do with the loading time of image planes.
     /// So the current camera in the view is not always the same
     /// than the "last loaded image plane".
     static std::map<std::string, std::string> _lastLoadedCameraByView;
+    /// Incremented each time the displayed cameras change: queued prefetches of an older
+    /// generation are not relevant anymore and are skipped.
+    static unsigned int _imagePrefetchGeneration;
 };
 
 } // namespace
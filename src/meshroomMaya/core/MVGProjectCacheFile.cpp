@@ -0,0 +1,206 @@
+#include "meshroomMaya/core/MVGProjectCacheFile.hpp"
+#include "meshroomMaya/core/MVGPointCloudStore.hpp"
+#include "meshroomMaya/core/MVGVisibilityGraph.hpp"
+#include "meshroomMaya/core/MVGPlaneSegmentation.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+static const uint32_t CACHE_MAGIC = 0x4347564d; // "MVGC"
+static const uint32_t CACHE_VERSION = 2;
+static const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    int64_t sourceByteSize;
+    int64_t sourceLastModified;
+    uint64_t camerasHash;
+};
+
+/// array size, then raw content padded to 8 bytes
+template <typename T>
+void writeArray(std::ostream& stream, const T* data, const size_t count)
+{
+    static const char padding[8] = {0};
+    const uint64_t size = count;
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    stream.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+    stream.write(padding, (8 - (count * sizeof(T)) % 8) % 8);
+}
+
+template <typename T>
+bool readArray(std::istream& stream, std::vector<T>& array)
+{
+    uint64_t size = 0;
+    if(!stream.read(reinterpret_cast<char*>(&size), sizeof(size)))
+        return false;
+    // do not trust a corrupted size before allocating
+    const std::streamoff position = stream.tellg();
+    stream.seekg(0, std::ios::end);
+    const std::streamoff remaining = stream.tellg() - position;
+    stream.seekg(position);
+    if(size > static_cast<uint64_t>(remaining) / sizeof(T))
+        return false;
+    array.resize(size);
+    char padding[8];
+    stream.read(reinterpret_cast<char*>(array.data()), size * sizeof(T));
+    stream.read(padding, (8 - (size * sizeof(T)) % 8) % 8);
+    return static_cast<bool>(stream);
+}
+
+} // empty namespace
+
+/**
+ * @param abcFilePath path of the abc file of the project
+ * @return path of the cache file, next to the abc file
+ */
+// static
+std::string MVGProjectCacheFile::getCachePath(const std::string& abcFilePath)
+{
+    if(abcFilePath.empty())
+        return std::string();
+    return abcFilePath + ".mvgcache";
+}
+
+/**
+ * @param cameraIds view ids of the cameras of the scene, in any order
+ * @return FNV-1a hash of the sorted ids
+ */
+// static
+uint64_t MVGProjectCacheFile::hashCameraIds(std::vector<int> cameraIds)
+{
+    std::sort(cameraIds.begin(), cameraIds.end());
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < cameraIds.size(); ++i)
+    {
+        const uint32_t id = static_cast<uint32_t>(cameraIds[i]);
+        for(int b = 0; b < 4; ++b)
+        {
+            hash ^= (id >> (8 * b)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+/**
+ * Write the cache to a temporary file first, so that a failed write never leaves a truncated
+ * cache behind.
+ */
+// static
+bool MVGProjectCacheFile::write(const std::string& path, const Source& source,
+                                const MVGPointCloudStore& store,
+                                const MVGVisibilityGraph& visibilityGraph,
+                                const MVGPlaneSegmentation& planeSegmentation)
+{
+    if(path.empty())
+        return false;
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream stream(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+        if(!stream)
+            return false;
+        Header header;
+        header.magic = CACHE_MAGIC;
+        header.version = CACHE_VERSION;
+        header.byteOrder = CACHE_BYTE_ORDER;
+        header.reserved = 0;
+        header.sourceByteSize = source.byteSize;
+        header.sourceLastModified = source.lastModified;
+        header.camerasHash = source.camerasHash;
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        // points
+        writeArray(stream, store.getXData(), store.size());
+        writeArray(stream, store.getYData(), store.size());
+        writeArray(stream, store.getZData(), store.size());
+        // visibility
+        const std::vector<int>* arrays[] = {
+            &visibilityGraph.getCameraIds(), &visibilityGraph.getPointOffsets(),
+            &visibilityGraph.getPointCameras(), &visibilityGraph.getCameraOffsets(),
+            &visibilityGraph.getCameraPoints()};
+        for(size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); ++i)
+            writeArray(stream, arrays[i]->data(), arrays[i]->size());
+        // planes
+        writeArray(stream, planeSegmentation.getPointPlanes().data(),
+                   planeSegmentation.getPointsCount());
+        writeArray(stream, planeSegmentation.getPlanes().data(),
+                   planeSegmentation.getPlanes().size());
+        if(!stream)
+        {
+            stream.close();
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @param[in] path : cache file
+ * @param[in] source : expected source, the cache is ignored if it does not match
+ * @param[out] store : point positions, left untouched if the cache is not valid
+ * @param[out] visibilityGraph : visibility, left untouched if the cache is not valid
+ * @param[out] planeSegmentation : planes of the points, empty if not computed yet
+ * @return whether the cache is valid and has been read
+ */
+// static
+bool MVGProjectCacheFile::read(const std::string& path, const Source& source,
+                               MVGPointCloudStore& store, MVGVisibilityGraph& visibilityGraph,
+                               MVGPlaneSegmentation& planeSegmentation)
+{
+    if(path.empty())
+        return false;
+    std::ifstream stream(path.c_str(), std::ios::binary);
+    if(!stream)
+        return false;
+    Header header;
+    if(!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+    if(header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+       header.byteOrder != CACHE_BYTE_ORDER)
+        return false;
+    if(header.sourceByteSize != source.byteSize ||
+       header.sourceLastModified != source.lastModified ||
+       header.camerasHash != source.camerasHash)
+        return false;
+
+    std::vector<double> x, y, z;
+    if(!readArray(stream, x) || !readArray(stream, y) || !readArray(stream, z) ||
+       x.size() != y.size() || x.size() != z.size())
+        return false;
+    std::vector<int> cameraIds, pointOffsets, pointCameras, cameraOffsets, cameraPoints;
+    if(!readArray(stream, cameraIds) || !readArray(stream, pointOffsets) ||
+       !readArray(stream, pointCameras) || !readArray(stream, cameraOffsets) ||
+       !readArray(stream, cameraPoints))
+        return false;
+
+    std::vector<int> pointPlanes;
+    std::vector<double> planes;
+    if(!readArray(stream, pointPlanes) || !readArray(stream, planes) ||
+       (!pointPlanes.empty() && pointPlanes.size() != x.size()))
+        return false;
+
+    MVGVisibilityGraph graph;
+    if(!graph.assign(cameraIds, pointOffsets, pointCameras, cameraOffsets, cameraPoints))
+        return false;
+    MVGPlaneSegmentation segmentation;
+    if(!segmentation.assign(pointPlanes, planes))
+        return false;
+    store.assign(x, y, z);
+    visibilityGraph.swap(graph);
+    planeSegmentation.swap(segmentation);
+    return true;
+}
+
+} // namespace
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace meshroomMaya
+{
+
+class MVGPointCloudStore;
+class MVGVisibilityGraph;
+class MVGPlaneSegmentation;
+
+/**
+ * @brief Binary snapshot of the data decoded at project load, written next to the abc file
+ * (<file>.abc.mvgcache).
+ *
+ * Holds the point positions, the visibility graph and the plane segmentation of the points as
+ * raw little endian arrays, each one 8 bytes aligned, so that re-opening a scene only has to
+ * copy them back. The segmentation is computed in the background, it may be empty. The file is
+ * discarded if its version, the abc file size and modification date, or the cameras of the
+ * scene do not match. Array values are checked on read, so that a corrupted file is discarded
+ * too.
+ * Camera intrinsics and poses are not stored: the Maya camera nodes are the reference for them
+ * (they may be edited and saved with the scene while the abc file stays the same), and
+ * MVGProjectionCache computes them lazily, per camera, from these nodes.
+ * This class does not depend on Maya.
+ */
+class MVGProjectCacheFile
+{
+
+public:
+    /// identity of the data the cache has been built from
+    struct Source
+    {
+        Source()
+            : byteSize(0)
+            , lastModified(0)
+            , camerasHash(0)
+        {
+        }
+        int64_t byteSize;
+        int64_t lastModified;
+        uint64_t camerasHash;
+    };
+
+public:
+    static std::string getCachePath(const std::string& abcFilePath);
+    static uint64_t hashCameraIds(std::vector<int> cameraIds);
+    static bool write(const std::string& path, const Source& source,
+                      const MVGPointCloudStore& store, const MVGVisibilityGraph& visibilityGraph,
+                      const MVGPlaneSegmentation& planeSegmentation);
+    static bool read(const std::string& path, const Source& source, MVGPointCloudStore& store,
+                     MVGVisibilityGraph& visibilityGraph,
+                     MVGPlaneSegmentation& planeSegmentation);
+};
+
+} // namespace
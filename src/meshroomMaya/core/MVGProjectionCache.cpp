@@ -0,0 +1,153 @@
+#include "meshroomMaya/core/MVGProjectionCache.hpp"
+#include "meshroomMaya/core/MVGCamera.hpp"
+#include "meshroomMaya/core/MVGLog.hpp"
+#include "meshroomMaya/core/MVGGeometryUtil.hpp"
+#include "meshroomMaya/maya/MVGMayaUtil.hpp"
+#include <aliceVision/multiview/projection.hpp>
+#include <maya/MNodeMessage.h>
+#include <maya/MFnCamera.h>
+#include <maya/MMatrix.h>
+#include <maya/MTransformationMatrix.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MIntArray.h>
+#include <cassert>
+#include <stdint.h>
+
+namespace meshroomMaya
+{
+
+MVGProjectionCache::ProjectionMap MVGProjectionCache::_projections;
+std::map<int, MCallbackIdArray> MVGProjectionCache::_callbacks;
+
+/**
+ * Same convention as MVGGeometryUtil::cameraToImageSpace.
+ */
+aliceVision::Vec2
+MVGProjectionCache::CameraProjection::cameraToImageSpace(const MPoint& cameraPoint) const
+{
+    assert(horizontalFilmAperture != 0.0);
+    const MPoint pointCenteredNorm = cameraPoint / horizontalFilmAperture;
+    const double verticalMargin = (sensorWidth - sensorHeight) / 2.0;
+    return aliceVision::Vec2((pointCenteredNorm.x + 0.5) * sensorWidth,
+                             (-pointCenteredNorm.y + 0.5) * sensorWidth - verticalMargin);
+}
+
+/**
+ * @param[in] cameraId camera view id
+ * @return cached projection data, NULL if the camera can't be found
+ */
+// static
+const MVGProjectionCache::CameraProjection* MVGProjectionCache::getProjection(const int cameraId)
+{
+    ProjectionMap::const_iterator it = _projections.find(cameraId);
+    if(it != _projections.end())
+        return &(it->second);
+
+    MVGCamera camera(cameraId);
+    if(!camera.isValid())
+        return NULL;
+    CameraProjection projection;
+    if(!computeProjection(camera, projection))
+        return NULL;
+    addCameraCallbacks(cameraId, camera);
+    return &(_projections.insert(std::make_pair(cameraId, projection)).first->second);
+}
+
+// static
+void MVGProjectionCache::invalidate(const int cameraId)
+{
+    _projections.erase(cameraId);
+}
+
+// static
+void MVGProjectionCache::clear()
+{
+    _projections.clear();
+    for(std::map<int, MCallbackIdArray>::iterator it = _callbacks.begin(); it != _callbacks.end();
+        ++it)
+        MMessage::removeCallbacks(it->second);
+    _callbacks.clear();
+}
+
+// static
+bool MVGProjectionCache::computeProjection(const MVGCamera& camera, CameraProjection& projection)
+{
+    MStatus status;
+    // Retrieve the intrinsic matrix from 'pinholeProjectionMatrix' attribute
+    //
+    // K Matrix:
+    // f*k_u     0      c_u
+    //   0     f*k_v    c_v
+    //   0       0       1
+    // c_u, c_v : the principal point, which would be ideally in the centre of the image.
+    //
+    MDoubleArray intrinsicsArray;
+    status = MVGMayaUtil::getDoubleArrayAttribute(camera.getDagPath().node(),
+                                                  "mvg_intrinsicParams", intrinsicsArray);
+    CHECK_RETURN_VARIABLE(status, false)
+    CHECK_RETURN_VARIABLE(intrinsicsArray.length() > 0, false)
+    MIntArray sensorSize;
+    camera.getSensorSize(sensorSize);
+    CHECK_RETURN_VARIABLE(sensorSize.length() > 1, false)
+
+    // Keep ideal matrix with principal point centered
+    aliceVision::Mat3 K;
+    K << intrinsicsArray[0], 0.0, sensorSize[0] / 2.0, 0.0, intrinsicsArray[0],
+        sensorSize[1] / 2.0, 0.0, 0.0, 1.0;
+
+    // Retrieve transformation matrix
+    const MMatrix inclusiveMatrix = camera.getDagPath().inclusiveMatrix();
+    const MTransformationMatrix transformMatrix(inclusiveMatrix);
+    aliceVision::Mat3 R;
+    MMatrix rotationMatrix = transformMatrix.asRotateMatrix();
+    for(int m = 0; m < 3; ++m)
+    {
+        for(int j = 0; j < 3; ++j)
+        {
+            // Maya has inverted Y and Z axes
+            int sign = 1;
+            if(m > 0)
+                sign = -1;
+            R(m, j) = sign * rotationMatrix[m][j];
+        }
+    }
+
+    // Retrieve translation vector
+    const aliceVision::Vec3 C = TO_VEC3(camera.getCenter());
+    const aliceVision::Vec3 t = -R * C;
+
+    // Compute projection matrix
+    aliceVision::P_From_KRt(K, R, t, &projection.P);
+
+    // Image space conversion parameters
+    projection.sensorWidth = sensorSize[0];
+    projection.sensorHeight = sensorSize[1];
+    projection.horizontalFilmAperture = camera.getHorizontalFilmAperture();
+    return true;
+}
+
+// static
+void MVGProjectionCache::addCameraCallbacks(const int cameraId, const MVGCamera& camera)
+{
+    if(_callbacks.count(cameraId))
+        return;
+    MStatus status;
+    // camera id is passed as the client data
+    void* clientData = reinterpret_cast<void*>(static_cast<intptr_t>(cameraId));
+    MObject transform = camera.getDagPath().transform();
+    MObject shape = camera.getDagPath().node();
+    MCallbackIdArray& callbacks = _callbacks[cameraId];
+    callbacks.append(MNodeMessage::addNodeDirtyCallback(transform, cameraDirtyCB, clientData,
+                                                        &status));
+    CHECK(status)
+    callbacks.append(MNodeMessage::addNodeDirtyCallback(shape, cameraDirtyCB, clientData, &status));
+    CHECK(status)
+}
+
+// static
+void MVGProjectionCache::cameraDirtyCB(MObject& node, void* cameraId)
+{
+    invalidate(static_cast<int>(reinterpret_cast<intptr_t>(cameraId)));
+}
+
+} // namespace
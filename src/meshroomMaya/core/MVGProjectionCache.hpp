@@ -0,0 +1,56 @@
+#pragma once
+
+#include "meshroomMaya/core/MVGEigen.hpp"
+#include <maya/MCallbackIdArray.h>
+#include <maya/MPoint.h>
+#include <map>
+
+class MObject;
+
+namespace meshroomMaya
+{
+
+class MVGCamera;
+
+/**
+ * @brief Camera id keyed cache of the data needed by the N-view triangulation.
+ *
+ * Building a projection matrix requires several plug lookups and a matrix decomposition.
+ * Entries are computed on first access and invalidated by node dirty callbacks registered on
+ * the camera transform and shape nodes.
+ */
+class MVGProjectionCache
+{
+
+public:
+    struct CameraProjection
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+        aliceVision::Vec2 cameraToImageSpace(const MPoint& cameraPoint) const;
+
+        aliceVision::Mat34 P; // projection matrix (image space)
+        double sensorWidth;
+        double sensorHeight;
+        double horizontalFilmAperture;
+    };
+
+public:
+    static const CameraProjection* getProjection(const int cameraId);
+    static void invalidate(const int cameraId);
+    static void clear();
+
+private:
+    static bool computeProjection(const MVGCamera& camera, CameraProjection& projection);
+    static void addCameraCallbacks(const int cameraId, const MVGCamera& camera);
+    static void cameraDirtyCB(MObject& node, void* cameraId);
+
+private:
+    typedef std::map<int, CameraProjection, std::less<int>,
+                     Eigen::aligned_allocator<std::pair<const int, CameraProjection> > >
+        ProjectionMap;
+    static ProjectionMap _projections;
+    static std::map<int, MCallbackIdArray> _callbacks;
+};
+
+} // namespace
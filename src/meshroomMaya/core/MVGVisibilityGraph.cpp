@@ -0,0 +1,322 @@
+#include "meshroomMaya/core/MVGVisibilityGraph.hpp"
+#include "meshroomMaya/core/MVGParallel.hpp"
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+/// below this number of points, decoding is not worth spawning threads
+static const size_t MIN_POINTS_PER_THREAD = 65536;
+
+} // empty namespace
+
+void MVGVisibilityGraph::clear()
+{
+    _cameraIds.clear();
+    _pointOffsets.clear();
+    _pointCameras.clear();
+    _cameraOffsets.clear();
+    _cameraPoints.clear();
+}
+
+void MVGVisibilityGraph::swap(MVGVisibilityGraph& other)
+{
+    _cameraIds.swap(other._cameraIds);
+    _pointOffsets.swap(other._pointOffsets);
+    _pointCameras.swap(other._pointCameras);
+    _cameraOffsets.swap(other._cameraOffsets);
+    _cameraPoints.swap(other._cameraPoints);
+}
+
+/**
+ * Build both point and camera groupings with counting sorts.
+ * @param[in] pointsCount : number of points of the cloud, extended if an observation refers to
+ * a point id out of range
+ * @param[in] observationCameraIds : view id of each observation
+ * @param[in] observationPointIds : point id of each observation
+ */
+void MVGVisibilityGraph::build(const size_t pointsCount,
+                               const std::vector<int>& observationCameraIds,
+                               const std::vector<int>& observationPointIds)
+{
+    assert(observationCameraIds.size() == observationPointIds.size());
+    clear();
+
+    // camera ids -> dense indexes
+    _cameraIds = observationCameraIds;
+    std::sort(_cameraIds.begin(), _cameraIds.end());
+    _cameraIds.erase(std::unique(_cameraIds.begin(), _cameraIds.end()), _cameraIds.end());
+    size_t nbPoints = pointsCount;
+    for(size_t i = 0; i < observationPointIds.size(); ++i)
+    {
+        if(observationPointIds[i] >= 0)
+            nbPoints = std::max(nbPoints, static_cast<size_t>(observationPointIds[i]) + 1);
+    }
+
+    // group by point
+    _pointOffsets.assign(nbPoints + 1, 0);
+    for(size_t i = 0; i < observationPointIds.size(); ++i)
+    {
+        if(observationPointIds[i] >= 0)
+            ++_pointOffsets[observationPointIds[i] + 1];
+    }
+    for(size_t p = 1; p < _pointOffsets.size(); ++p)
+        _pointOffsets[p] += _pointOffsets[p - 1];
+    _pointCameras.resize(_pointOffsets.back());
+    std::vector<int> fill(_pointOffsets.begin(), _pointOffsets.end() - 1);
+    for(size_t i = 0; i < observationPointIds.size(); ++i)
+    {
+        if(observationPointIds[i] >= 0)
+            _pointCameras[fill[observationPointIds[i]]++] = getCameraIndex(observationCameraIds[i]);
+    }
+
+    groupByCamera(1);
+}
+
+/**
+ * Build the graph from visibility arrays grouped by point, as stored in the abc point cloud
+ * (mvg_visibilitySize / mvg_visibilityIds), decoding them on several threads.
+ * Point offsets are the prefix sum of the visibility sizes, then each thread translates the view
+ * ids of a contiguous range of points and scatters them to their camera ranges.
+ * @param[in] visibilitySizes : number of observations of each point
+ * @param[in] pointsCount : number of points (length of visibilitySizes)
+ * @param[in] visibilityIds : observation records, the view id being the first int of each
+ * @param[in] visibilityIdsCount : length of visibilityIds
+ * @param[in] stride : number of ints of an observation record
+ * @param[in] threadsCount : number of threads to use, 0 to use all available cores
+ */
+void MVGVisibilityGraph::buildFromPointVisibility(const int* visibilitySizes,
+                                                  const size_t pointsCount,
+                                                  const int* visibilityIds,
+                                                  const size_t visibilityIdsCount,
+                                                  const size_t stride, size_t threadsCount)
+{
+    assert(stride > 0);
+    clear();
+    const size_t nbObservations = visibilityIdsCount / stride;
+    if(threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadsCount = std::max<size_t>(
+        std::min(threadsCount, pointsCount / MIN_POINTS_PER_THREAD), 1);
+
+    // first pass: point offsets, truncated to the available observations
+    _pointOffsets.resize(pointsCount + 1);
+    _pointOffsets[0] = 0;
+    for(size_t p = 0; p < pointsCount; ++p)
+        _pointOffsets[p + 1] = static_cast<int>(std::min(
+            static_cast<size_t>(_pointOffsets[p] + std::max(visibilitySizes[p], 0)),
+            nbObservations));
+    const size_t nbValidObservations = _pointOffsets.back();
+
+    // camera ids -> dense indexes, unique ids of each chunk being merged afterwards
+    std::vector<std::vector<int> > chunkCameraIds(threadsCount);
+    parallelForChunks(threadsCount, nbValidObservations,
+                      [&](const size_t chunk, const size_t begin, const size_t end)
+                      {
+                          // few cameras for many observations: keep the ids sorted on insertion
+                          std::vector<int>& ids = chunkCameraIds[chunk];
+                          for(size_t i = begin; i < end; ++i)
+                          {
+                              const int id = visibilityIds[i * stride];
+                              std::vector<int>::iterator it =
+                                  std::lower_bound(ids.begin(), ids.end(), id);
+                              if(it == ids.end() || *it != id)
+                                  ids.insert(it, id);
+                          }
+                      });
+    for(size_t c = 0; c < chunkCameraIds.size(); ++c)
+        _cameraIds.insert(_cameraIds.end(), chunkCameraIds[c].begin(), chunkCameraIds[c].end());
+    std::sort(_cameraIds.begin(), _cameraIds.end());
+    _cameraIds.erase(std::unique(_cameraIds.begin(), _cameraIds.end()), _cameraIds.end());
+
+    // second pass: translate view ids to camera indexes, already grouped by point
+    _pointCameras.resize(nbValidObservations);
+    parallelForChunks(threadsCount, nbValidObservations,
+                      [&](const size_t, const size_t begin, const size_t end)
+                      {
+                          for(size_t i = begin; i < end; ++i)
+                              _pointCameras[i] = getCameraIndex(visibilityIds[i * stride]);
+                      });
+
+    groupByCamera(threadsCount);
+}
+
+/**
+ * Take ownership of already built arrays (see the raw array getters), the given vectors being
+ * left empty. The arrays come from a file: sizes and values are checked (sorted camera ids,
+ * monotonic offsets, camera indexes and point ids in range, point ids sorted in each camera
+ * range) so that a corrupted file can't lead to out of bounds accesses.
+ * @return false and leave the graph empty if the arrays are not consistent
+ */
+bool MVGVisibilityGraph::assign(std::vector<int>& cameraIds, std::vector<int>& pointOffsets,
+                                std::vector<int>& pointCameras, std::vector<int>& cameraOffsets,
+                                std::vector<int>& cameraPoints)
+{
+    clear();
+    if(pointOffsets.empty() || static_cast<size_t>(pointOffsets.back()) != pointCameras.size())
+        return false;
+    if(cameraOffsets.size() != cameraIds.size() + 1 ||
+       static_cast<size_t>(cameraOffsets.back()) != cameraPoints.size() ||
+       cameraPoints.size() != pointCameras.size())
+        return false;
+    if(pointOffsets.front() != 0 || cameraOffsets.front() != 0)
+        return false;
+    for(size_t c = 1; c < cameraIds.size(); ++c)
+    {
+        if(cameraIds[c - 1] >= cameraIds[c])
+            return false;
+    }
+    for(size_t p = 1; p < pointOffsets.size(); ++p)
+    {
+        if(pointOffsets[p - 1] > pointOffsets[p])
+            return false;
+    }
+    const int nbCameras = static_cast<int>(cameraIds.size());
+    for(size_t i = 0; i < pointCameras.size(); ++i)
+    {
+        if(pointCameras[i] < 0 || pointCameras[i] >= nbCameras)
+            return false;
+    }
+    const int nbPoints = static_cast<int>(pointOffsets.size() - 1);
+    for(size_t c = 0; c < cameraIds.size(); ++c)
+    {
+        if(cameraOffsets[c] > cameraOffsets[c + 1])
+            return false;
+        for(int i = cameraOffsets[c]; i < cameraOffsets[c + 1]; ++i)
+        {
+            if(cameraPoints[i] < 0 || cameraPoints[i] >= nbPoints ||
+               (i > cameraOffsets[c] && cameraPoints[i - 1] >= cameraPoints[i]))
+                return false;
+        }
+    }
+    _cameraIds.swap(cameraIds);
+    _pointOffsets.swap(pointOffsets);
+    _pointCameras.swap(pointCameras);
+    _cameraOffsets.swap(cameraOffsets);
+    _cameraPoints.swap(cameraPoints);
+    return true;
+}
+
+/**
+ * Fill the camera grouping from the point grouping. Each thread counts the observations of a
+ * contiguous range of points per camera, so that it can scatter them to its own slice of every
+ * camera range; ranges stay sorted by point id.
+ */
+void MVGVisibilityGraph::groupByCamera(const size_t threadsCount)
+{
+    const size_t nbPoints = getPointsCount();
+    const size_t nbCameras = _cameraIds.size();
+    std::vector<std::vector<int> > chunkFill(threadsCount, std::vector<int>(nbCameras, 0));
+    parallelForChunks(threadsCount, nbPoints,
+                      [&](const size_t chunk, const size_t begin, const size_t end)
+                      {
+                          std::vector<int>& counts = chunkFill[chunk];
+                          for(int i = _pointOffsets[begin]; i < _pointOffsets[end]; ++i)
+                              ++counts[_pointCameras[i]];
+                      });
+
+    // camera offsets, and write position of each chunk in each camera range
+    _cameraOffsets.resize(nbCameras + 1);
+    int offset = 0;
+    for(size_t c = 0; c < nbCameras; ++c)
+    {
+        _cameraOffsets[c] = offset;
+        for(size_t chunk = 0; chunk < threadsCount; ++chunk)
+        {
+            const int count = chunkFill[chunk][c];
+            chunkFill[chunk][c] = offset;
+            offset += count;
+        }
+    }
+    _cameraOffsets[nbCameras] = offset;
+
+    _cameraPoints.resize(offset);
+    parallelForChunks(threadsCount, nbPoints,
+                      [&](const size_t chunk, const size_t begin, const size_t end)
+                      {
+                          std::vector<int>& fill = chunkFill[chunk];
+                          for(size_t p = begin; p < end; ++p)
+                          {
+                              for(int i = _pointOffsets[p]; i < _pointOffsets[p + 1]; ++i)
+                                  _cameraPoints[fill[_pointCameras[i]]++] = p;
+                          }
+                      });
+}
+
+/**
+ * Count, for each camera, how many of the given points it sees.
+ * Each thread counts a contiguous part of the points in its own array, arrays being summed
+ * afterwards.
+ * @param[in] pointIds : ids of the points, ids without observation are ignored
+ * @param[out] countPerCamera : number of points seen by each camera, by camera index
+ * @param[in] threadsCount : number of threads to use, 0 to use all available cores
+ */
+void MVGVisibilityGraph::countPointsPerCamera(const std::vector<int>& pointIds,
+                                              std::vector<int>& countPerCamera,
+                                              size_t threadsCount) const
+{
+    if(threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadsCount =
+        std::max<size_t>(std::min(threadsCount, pointIds.size() / MIN_POINTS_PER_THREAD), 1);
+
+    std::vector<std::vector<int> > chunkCounts(threadsCount);
+    parallelForChunks(threadsCount, pointIds.size(),
+                      [&](const size_t chunk, const size_t begin, const size_t end)
+                      {
+                          std::vector<int>& counts = chunkCounts[chunk];
+                          counts.assign(_cameraIds.size(), 0);
+                          for(size_t i = begin; i < end; ++i)
+                          {
+                              const Range cameras = getPointCameras(pointIds[i]);
+                              for(const int* it = cameras.begin(); it != cameras.end(); ++it)
+                                  ++counts[*it];
+                          }
+                      });
+    countPerCamera.swap(chunkCounts[0]);
+    for(size_t chunk = 1; chunk < threadsCount; ++chunk)
+    {
+        for(size_t c = 0; c < countPerCamera.size(); ++c)
+            countPerCamera[c] += chunkCounts[chunk][c];
+    }
+}
+
+/**
+ * @return the dense index of the camera, -1 if the camera has no observation
+ */
+int MVGVisibilityGraph::getCameraIndex(const int cameraId) const
+{
+    std::vector<int>::const_iterator it =
+        std::lower_bound(_cameraIds.begin(), _cameraIds.end(), cameraId);
+    if(it == _cameraIds.end() || *it != cameraId)
+        return -1;
+    return it - _cameraIds.begin();
+}
+
+MVGVisibilityGraph::Range MVGVisibilityGraph::getCameraPoints(const int cameraId) const
+{
+    return getCameraPointsByIndex(getCameraIndex(cameraId));
+}
+
+MVGVisibilityGraph::Range MVGVisibilityGraph::getCameraPointsByIndex(const int cameraIndex) const
+{
+    if(cameraIndex < 0 || static_cast<size_t>(cameraIndex) >= _cameraIds.size())
+        return Range();
+    return Range(_cameraPoints.data() + _cameraOffsets[cameraIndex],
+                 _cameraPoints.data() + _cameraOffsets[cameraIndex + 1]);
+}
+
+MVGVisibilityGraph::Range MVGVisibilityGraph::getPointCameras(const int pointId) const
+{
+    if(pointId < 0 || static_cast<size_t>(pointId) >= getPointsCount())
+        return Range();
+    return Range(_pointCameras.data() + _pointOffsets[pointId],
+                 _pointCameras.data() + _pointOffsets[pointId + 1]);
+}
+
+} // namespace
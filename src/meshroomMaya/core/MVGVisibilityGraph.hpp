@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Bidirectional camera/point visibility of the reconstruction, in compressed sparse row
+ * layout.
+ *
+ * Observations are stored twice, grouped by point (point -> camera indexes) and grouped by
+ * camera (camera -> point ids, in increasing order), each group being a contiguous range of
+ * one index array. Cameras are identified by their view id (see MVGCamera::getId) and addressed
+ * internally by a dense index, in increasing view id order.
+ * This class does not depend on Maya.
+ */
+class MVGVisibilityGraph
+{
+
+public:
+    /// Contiguous range of indexes
+    struct Range
+    {
+        Range()
+            : first(NULL)
+            , last(NULL)
+        {
+        }
+        Range(const int* first, const int* last)
+            : first(first)
+            , last(last)
+        {
+        }
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+        int operator[](const size_t i) const { return first[i]; }
+
+        const int* first;
+        const int* last;
+    };
+
+public:
+    void clear();
+    void swap(MVGVisibilityGraph& other);
+    void build(const size_t pointsCount, const std::vector<int>& observationCameraIds,
+               const std::vector<int>& observationPointIds);
+    void buildFromPointVisibility(const int* visibilitySizes, const size_t pointsCount,
+                                  const int* visibilityIds, const size_t visibilityIdsCount,
+                                  const size_t stride, size_t threadsCount = 0);
+    bool assign(std::vector<int>& cameraIds, std::vector<int>& pointOffsets,
+                std::vector<int>& pointCameras, std::vector<int>& cameraOffsets,
+                std::vector<int>& cameraPoints);
+
+public:
+    bool empty() const { return _cameraIds.empty(); }
+    size_t getPointsCount() const { return _pointOffsets.empty() ? 0 : _pointOffsets.size() - 1; }
+    size_t getCamerasCount() const { return _cameraIds.size(); }
+    size_t getObservationsCount() const { return _pointCameras.size(); }
+    int getCameraIndex(const int cameraId) const;
+    int getCameraId(const int cameraIndex) const { return _cameraIds[cameraIndex]; }
+    /// point ids visible by the camera, sorted
+    Range getCameraPoints(const int cameraId) const;
+    Range getCameraPointsByIndex(const int cameraIndex) const;
+    /// indexes of the cameras the point is visible by
+    Range getPointCameras(const int pointId) const;
+    void countPointsPerCamera(const std::vector<int>& pointIds, std::vector<int>& countPerCamera,
+                              size_t threadsCount = 0) const;
+    /// raw arrays, for serialization
+    const std::vector<int>& getCameraIds() const { return _cameraIds; }
+    const std::vector<int>& getPointOffsets() const { return _pointOffsets; }
+    const std::vector<int>& getPointCameras() const { return _pointCameras; }
+    const std::vector<int>& getCameraOffsets() const { return _cameraOffsets; }
+    const std::vector<int>& getCameraPoints() const { return _cameraPoints; }
+
+private:
+    void groupByCamera(const size_t threadsCount);
+
+private:
+    /// sorted view ids, position in this array being the camera index
+    std::vector<int> _cameraIds;
+    /// point -> camera indexes, _pointOffsets[p] to _pointOffsets[p+1] being the range of point p
+    std::vector<int> _pointOffsets;
+    std::vector<int> _pointCameras;
+    /// camera -> point ids, _cameraOffsets[c] to _cameraOffsets[c+1] being the range of camera c
+    std::vector<int> _cameraOffsets;
+    std::vector<int> _cameraPoints;
+};
+
+} // namespace
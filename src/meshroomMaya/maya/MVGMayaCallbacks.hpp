@@ -4,9 +4,12 @@
 #include "meshroomMaya/core/MVGMesh.hpp"
 #include "meshroomMaya/qt/MVGPanelWrapper.hpp"
 #include "meshroomMaya/qt/MVGMainWidget.hpp"
+#include "meshroomMaya/qt/MVGImageMetadataIndex.hpp"
 #include "meshroomMaya/maya/context/MVGMoveManipulator.hpp"
 #include "meshroomMaya/maya/context/MVGContext.hpp"
 #include "meshroomMaya/maya/context/MVGContextCmd.hpp"
+#include "meshroomMaya/maya/cmd/MVGEditCmd.hpp"
+#include "meshroomMaya/maya/cmd/MVGRetriangulateCmd.hpp"
 #include <maya/MGlobal.h>
 #include <maya/MFnDependencyNode.h>
 #include <maya/MFnDagNode.h>
@@ -32,6 +35,20 @@ MVGProjectWrapper* getProjectWrapper()
     return &mainWidget->getProjectWrapper();
 }
 
+/**
+ * @brief Whether undoing/redoing the given command requires to rebuild the manipulator cache.
+ * MVGEditCmd and MVGRetriangulateCmd (an MVGEditCmd) update the cache themselves, and selection
+ * actions don't modify any mesh.
+ */
+bool isMeshCacheRebuildNeeded(const MString& commandLine)
+{
+    const int spaceIndex = commandLine.index(' ');
+    const MString cmdName =
+        (spaceIndex < 0) ? commandLine : commandLine.substring(0, spaceIndex - 1);
+    return cmdName != "select" && cmdName != "miCreateDefaultPresets" &&
+           cmdName != MVGEditCmd::_name && cmdName != MVGRetriangulateCmd::_name;
+}
+
 } // empty namespace
 
 static void selectionChangedCB(void*)
@@ -136,16 +153,22 @@ static void newSceneCB(void*)
     MVGMayaUtil::deleteMVGWindow();
 }
 
+/**
+ * @brief Write the image metadata probed during this session, so that they are not lost if Maya
+ * does not exit cleanly.
+ */
+static void saveImageMetadataCB(void*)
+{
+    MVGImageMetadataIndex::save();
+}
+
 static void undoCB(void*)
 {
     // TODO : rebuild only the modified mesh
     // TODO : don't rebuild on action that don't modify any mesh
     MString redoName;
     MVGMayaUtil::getRedoName(redoName);
-    // Don't rebuild on selection
-    int spaceIndex = redoName.index(' ');
-    MString cmdName = redoName.substring(0, spaceIndex - 1);
-    if(cmdName != "select" && cmdName != "miCreateDefaultPresets")
+    if(isMeshCacheRebuildNeeded(redoName))
     {
         MString cmd;
         cmd.format("^1s -e -rebuild ^2s", MVGContextCmd::name, MVGContextCmd::instanceName);
@@ -157,10 +180,7 @@ static void redoCB(void*)
 {
     MString undoName;
     MVGMayaUtil::getUndoName(undoName);
-    // Don't rebuild if selection action
-    int spaceIndex = undoName.index(' ');
-    MString cmdName = undoName.substring(0, spaceIndex - 1);
-    if(cmdName != "select" && cmdName != "miCreateDefaultPresets")
+    if(isMeshCacheRebuildNeeded(undoName))
     {
         MString cmd;
         cmd.format("^1s -e -rebuild ^2s", MVGContextCmd::name, MVGContextCmd::instanceName);
@@ -222,6 +242,11 @@ static void nodeRemovedCB(MObject& node, void*)
             MGlobal::executeCommand(cmd);
             break;
         }
+        case MFn::kCamera:
+        {
+            project->removeCameraFromUI(node);
+            break;
+        }
         default:
             break;
     }
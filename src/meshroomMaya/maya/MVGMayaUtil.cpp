@@ -1,12 +1,14 @@
 #include "meshroomMaya/maya/MVGMayaUtil.hpp"
 #include "meshroomMaya/core/MVGCamera.hpp"
 #include "meshroomMaya/core/MVGLog.hpp"
+#include "meshroomMaya/core/MVGParticleSelection.hpp"
 #include "meshroomMaya/maya/context/MVGContextCmd.hpp"
 #include "meshroomMaya/maya/context/MVGContext.hpp"
 #include <maya/MFnDependencyNode.h>
 #include <maya/MGlobal.h>
 #include <maya/MQtUtil.h>
 #include <maya/MSelectionList.h>
+#include <maya/MFnSingleIndexedComponent.h>
 #include <maya/M3dView.h>
 #include <maya/MPlug.h>
 #include <maya/MDataHandle.h>
@@ -232,16 +234,40 @@ MStatus MVGMayaUtil::clearMayaSelection()
                                          "cmds.select(cl=True)");
 }
 
+/**
+ * Replace the active selection by the given particles, through an undoable select command.
+ * The selection list is built with a particle component, and only falls back to a MEL command
+ * (with contiguous indexes merged as pt[first:last] ranges) if the component can't be built.
+ */
 MStatus MVGMayaUtil::selectParticles(const MString &objectName, const std::set<int> &points)
 {
-    // Can't select particle components using maya C++ API
-    // Build our own comand manually
-    std::ostringstream s;
-    s << "select -r ";
-    for(const auto& pt : points)
-        s << objectName << ".pt[" << pt << "] ";
-    s << ";";
-    return MGlobal::executeCommand(s.str().c_str());
+    MStatus status;
+    MDagPath particlePath;
+    status = getDagPathByName(objectName, particlePath);
+    if(status)
+        status = particlePath.extendToShape();
+    if(status && !points.empty())
+    {
+        MIntArray indices;
+        indices.setLength(points.size());
+        unsigned int i = 0;
+        for(const auto& pt : points)
+            indices[i++] = pt;
+        MFnSingleIndexedComponent fnComponent;
+        MObject component = fnComponent.create(MFn::kDynParticleSetComponent, &status);
+        if(status)
+            status = fnComponent.addElements(indices);
+        if(status)
+        {
+            MSelectionList list;
+            status = list.add(particlePath, component);
+            if(status)
+                return MGlobal::selectCommand(list, MGlobal::kReplaceList);
+        }
+    }
+
+    return MGlobal::executeCommand(
+        getSelectParticlesCommand(objectName.asChar(), points).c_str());
 }
 
 MStatus MVGMayaUtil::getIntArrayAttribute(const MObject& object, const MString& param,
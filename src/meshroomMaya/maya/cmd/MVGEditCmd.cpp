@@ -3,16 +3,26 @@
 #include "meshroomMaya/core/MVGMesh.hpp"
 #include "meshroomMaya/core/MVGProject.hpp"
 #include "meshroomMaya/core/MVGLog.hpp"
+#include "meshroomMaya/maya/context/MVGContextCmd.hpp"
 #include <maya/MSyntax.h>
 #include <maya/MArgList.h>
 #include <maya/MArgDatabase.h>
 #include <maya/MFnPointArrayData.h>
 #include <maya/MFnIntArrayData.h>
+#include <maya/MGlobal.h>
 #include <cassert>
 
 namespace meshroomMaya
 {
 
+namespace
+{ // empty namespace
+
+/// above this number of edited vertices, the manipulator cache of the mesh is rebuilt
+static const unsigned int MAX_PATCHED_VERTICES = 256;
+
+} // empty namespace
+
 MString MVGEditCmd::_name("MVGEditCmd");
 
 MVGEditCmd::MVGEditCmd()
@@ -40,17 +50,31 @@ MStatus MVGEditCmd::doIt(const MArgList& args)
 {
     setMeshNode(_meshPath);
     setModifierNodeType(MVGMeshEditNode::_id);
-    return doModifyPoly();
+    MStatus status = doModifyPoly();
+    CHECK_RETURN_STATUS(status)
+    _updatedVertexIDs = _componentIDs;
+    if(_editType == MVGMeshEditFactory::kAddFace)
+    {
+        // the new face is the last one
+        MVGMesh mesh(_meshPath);
+        CHECK(mesh.getPolygonVertices(mesh.getPolygonsCount() - 1, _updatedVertexIDs))
+    }
+    updateManipulatorCache();
+    return status;
 }
 
 MStatus MVGEditCmd::redoIt()
 {
-    return redoModifyPoly();
+    MStatus status = redoModifyPoly();
+    updateManipulatorCache();
+    return status;
 }
 
 MStatus MVGEditCmd::undoIt()
 {
-    return undoModifyPoly();
+    MStatus status = undoModifyPoly();
+    updateManipulatorCache();
+    return status;
 }
 
 bool MVGEditCmd::isUndoable() const
@@ -143,4 +167,55 @@ void MVGEditCmd::clearBD(const MDagPath& meshPath, const MIntArray& componentIDs
     _componentIDs = componentIDs;
 }
 
+/**
+ * Move many vertices at once, without changing their blind data.
+ * @param[in] meshPath : mesh to edit
+ * @param[in] componentIDs : vertices to move
+ * @param[in] worldSpacePositions : new position of each vertex
+ */
+void MVGEditCmd::setPoints(const MDagPath& meshPath, const MIntArray& componentIDs,
+                           const MPointArray& worldSpacePositions)
+{
+    if(!meshPath.isValid())
+    {
+        LOG_ERROR("Mesh path is not valid : " << meshPath.fullPathName())
+        return;
+    }
+    _editType = MVGMeshEditFactory::kSetPoints;
+    _meshPath = meshPath;
+    _componentIDs = componentIDs;
+    _worldSpacePositions = worldSpacePositions;
+    _cameraSpacePositions.clear();
+    _cameraID = -1;
+    _clearBD = false;
+}
+
+/**
+ * Patch the manipulator cache with the vertices touched by this edit, instead of rebuilding
+ * the whole mesh cache. Edits touching many vertices rebuild the mesh cache, rather than
+ * sending all their ids through a MEL string.
+ */
+void MVGEditCmd::updateManipulatorCache() const
+{
+    MString cmd;
+    if(_editType == MVGMeshEditFactory::kSetPoints ||
+       _updatedVertexIDs.length() > MAX_PATCHED_VERTICES)
+    {
+        cmd.format("^1s -e -rebuild -mesh \"^2s\" ^3s", MVGContextCmd::name,
+                   _meshPath.fullPathName(), MVGContextCmd::instanceName);
+        CHECK(MGlobal::executeCommand(cmd))
+        return;
+    }
+    MString vertices;
+    for(size_t i = 0; i < _updatedVertexIDs.length(); ++i)
+    {
+        if(i > 0)
+            vertices += " ";
+        vertices += _updatedVertexIDs[i];
+    }
+    cmd.format("^1s -e -rebuild -mesh \"^2s\" -vertices \"^3s\" ^4s", MVGContextCmd::name,
+               _meshPath.fullPathName(), vertices, MVGContextCmd::instanceName);
+    CHECK(MGlobal::executeCommand(cmd))
+}
+
 } // namespace
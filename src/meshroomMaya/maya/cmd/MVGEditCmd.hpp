@@ -36,6 +36,11 @@ public:
               const MPointArray& worldSpacePositions, const MPointArray& cameraSpacePositions,
               const int cameraID, const bool clearBD = false);
     void clearBD(const MDagPath& meshPath, const MIntArray& componentIDs);
+    void setPoints(const MDagPath& meshPath, const MIntArray& componentIDs,
+                   const MPointArray& worldSpacePositions);
+
+private:
+    void updateManipulatorCache() const;
 
 public:
     static MString _name;
@@ -50,6 +55,7 @@ private:
     MPointArray _cameraSpacePositions;
     int _cameraID;
     bool _clearBD;
+    MIntArray _updatedVertexIDs; // vertices touched by this edit
 };
 
 } // namespace
@@ -17,7 +17,60 @@ static const char* panelFlag = "-p";
 static const char* panelFlagLong = "-panel";
 static const char* loadFlag = "-l";
 static const char* loadFlagLong = "-load";
+static const char* cameraFlag = "-c";
+static const char* cameraFlagLong = "-camera";
+static const char* prefetchFlag = "-pf";
+static const char* prefetchFlagLong = "-prefetch";
+static const char* generationFlag = "-g";
+static const char* generationFlagLong = "-generation";
+
+/**
+ * Set the "imageName" attribute of the image plane attached to the camera, if not already set.
+ * Maya then loads the image.
+ * @param[in] cameraPath : camera transform
+ */
+MStatus loadImagePlane(MDagPath cameraPath)
+{
+    MStatus status;
+    cameraPath.extendToShape();
+
+    // Retrieve image plane attached to camera
+    MFnDagNode fnCamera(cameraPath, &status);
+    MPlug imagePlanePlug = fnCamera.findPlug("imagePlane", status);
+    CHECK_RETURN_STATUS(status)
+    MPlug imagePlug = imagePlanePlug.elementByLogicalIndex(0, &status);
+    MPlugArray connectedPlugs;
+    imagePlug.connectedTo(connectedPlugs, true, true, &status);
+    CHECK_RETURN_STATUS(status)
+    if(connectedPlugs.length() == 0)
+    {
+        LOG_ERROR("No plug connected to the plug")
+        return MS::kFailure;
+    }
+    MDagPath imagePlaneShapeDagPath;
+    status = MDagPath::getAPathTo(connectedPlugs[0].node(), imagePlaneShapeDagPath);
+    CHECK(status)
+
+    MFnDagNode fnImagePlane(imagePlaneShapeDagPath, &status);
+    MPlug imageNamePlug = fnImagePlane.findPlug("imageName", &status);
+    CHECK_RETURN_STATUS(status)
+    MString imageNameValue;
+    imageNamePlug.getValue(imageNameValue);
+
+    // Set "imageName" attribute on image plane
+    MString imagePath =
+        fnCamera.findPlug(meshroomMaya::MVGCamera::_MVG_IMAGE_PATH, &status).asString();
+    CHECK_RETURN_STATUS(status)
+    if(imageNameValue != imagePath)
+    {
+        status = imageNamePlug.setValue(imagePath);
+        CHECK_RETURN_STATUS(status)
+    }
+    return status;
+}
+
 } // empty namespace
+
 namespace meshroomMaya
 {
 
@@ -33,6 +86,9 @@ MSyntax MVGImagePlaneCmd::newSyntax()
     MSyntax s;
     s.addFlag(panelFlag, panelFlagLong, MSyntax::kString);
     s.addFlag(loadFlag, loadFlagLong);
+    s.addFlag(cameraFlag, cameraFlagLong, MSyntax::kString);
+    s.addFlag(prefetchFlag, prefetchFlagLong);
+    s.addFlag(generationFlag, generationFlagLong, MSyntax::kLong);
     s.enableEdit(false);
     s.enableQuery(false);
     return s;
@@ -44,6 +100,43 @@ MStatus MVGImagePlaneCmd::doIt(const MArgList& args)
     MSyntax syntax = MVGImagePlaneCmd::newSyntax();
     MArgDatabase argData(syntax, args);
 
+    // -prefetch: load the image of a camera not displayed in any view and keep it in cache
+    if(argData.isFlagSet(prefetchFlag))
+    {
+        if(!argData.isFlagSet(cameraFlag))
+        {
+            LOG_ERROR("Need camera name to prefetch image")
+            return MS::kFailure;
+        }
+        MVGProject project(MVGProject::_PROJECT);
+        // -generation: skip the prefetches queued before the displayed cameras changed
+        if(argData.isFlagSet(generationFlag))
+        {
+            int generation = 0;
+            argData.getFlagArgument(generationFlag, 0, generation);
+            if(!project.isImagePrefetchCurrent(static_cast<unsigned int>(generation)))
+                return MS::kSuccess;
+        }
+        MString camera;
+        argData.getFlagArgument(cameraFlag, 0, camera);
+        MSelectionList list;
+        list.add(camera);
+        MDagPath dagPath;
+        status = list.getDagPath(0, dagPath);
+        CHECK_RETURN_STATUS(status)
+        if(dagPath.apiType() == MFn::kCamera)
+            dagPath.pop();
+        // Same naming as "modelPanel -q -camera", used as key by the image cache
+        const std::string cameraName = dagPath.partialPathName().asChar();
+        if(project.isCameraLoadedInView(cameraName) ||
+           project.getImageCache().contains(cameraName))
+            return MS::kSuccess;
+        status = loadImagePlane(dagPath);
+        CHECK_RETURN_STATUS(status)
+        project.pushImageInCache(cameraName, true);
+        return status;
+    }
+
     if(!argData.isFlagSet(panelFlag))
     {
         LOG_ERROR("Need panel name to load image")
@@ -61,43 +154,12 @@ MStatus MVGImagePlaneCmd::doIt(const MArgList& args)
         MString currentCamera;
         MGlobal::executeCommand(cmd, currentCamera);
 
-        // Retrieve image plane attached to camera
         MSelectionList list;
         list.add(currentCamera);
         MDagPath dagPath;
         list.getDagPath(0, dagPath);
-        dagPath.extendToShape();
-
-        MFnDagNode fnCamera(dagPath, &status);
-        MPlug imagePlanePlug = fnCamera.findPlug("imagePlane", status);
-        CHECK_RETURN_STATUS(status)
-        MPlug imagePlug = imagePlanePlug.elementByLogicalIndex(0, &status);
-        MPlugArray connectedPlugs;
-        imagePlug.connectedTo(connectedPlugs, true, true, &status);
+        status = loadImagePlane(dagPath);
         CHECK_RETURN_STATUS(status)
-        if(connectedPlugs.length() == 0)
-        {
-            LOG_ERROR("No plug connected to the plug")
-            return MS::kFailure;
-        }
-        MDagPath imagePlaneShapeDagPath;
-        status = MDagPath::getAPathTo(connectedPlugs[0].node(), imagePlaneShapeDagPath);
-        CHECK(status)
-
-        MFnDagNode fnImagePlane(imagePlaneShapeDagPath, &status);
-        MPlug imageNamePlug = fnImagePlane.findPlug("imageName", &status);
-        CHECK_RETURN_STATUS(status)
-        MString imageNameValue;
-        imageNamePlug.getValue(imageNameValue);
-
-        // Set "imageName" attribute on image plane
-        MString imagePath = fnCamera.findPlug(MVGCamera::_MVG_IMAGE_PATH, &status).asString();
-        CHECK_RETURN_STATUS(status)
-        if(imageNameValue != imagePath)
-        {
-            status = imageNamePlug.setValue(imagePath);
-            CHECK_RETURN_STATUS(status)
-        }
 
         // Update cache
         MVGProject project(MVGProject::_PROJECT);
@@ -0,0 +1,167 @@
+#include "meshroomMaya/maya/cmd/MVGRetriangulateCmd.hpp"
+#include "meshroomMaya/core/MVGMesh.hpp"
+#include "meshroomMaya/core/MVGProject.hpp"
+#include "meshroomMaya/core/MVGProjectionCache.hpp"
+#include "meshroomMaya/core/MVGPointTriangulator.hpp"
+#include "meshroomMaya/core/MVGParallel.hpp"
+#include "meshroomMaya/core/MVGLog.hpp"
+#include <maya/MSyntax.h>
+#include <maya/MArgDatabase.h>
+#include <algorithm>
+#include <map>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+static const char* meshFlag = "-m";
+static const char* meshFlagLong = "-mesh";
+
+/// below this number of vertices, triangulation is not worth spawning threads
+static const size_t MIN_VERTICES_PER_THREAD = 4096;
+
+} // empty namespace
+
+MString MVGRetriangulateCmd::_name("MVGRetriangulateCmd");
+
+MVGRetriangulateCmd::MVGRetriangulateCmd()
+    : _hasEdit(false)
+{
+}
+
+MVGRetriangulateCmd::~MVGRetriangulateCmd()
+{
+}
+
+void* MVGRetriangulateCmd::creator()
+{
+    return new MVGRetriangulateCmd();
+}
+
+MSyntax MVGRetriangulateCmd::newSyntax()
+{
+    MSyntax s;
+    s.addFlag(meshFlag, meshFlagLong, MSyntax::kString);
+    s.enableEdit(false);
+    s.enableQuery(false);
+    return s;
+}
+
+/**
+ * Blind data and camera projections are read from Maya first, the vertices are then
+ * triangulated in parallel.
+ * The result is the number of moved vertices.
+ */
+MStatus MVGRetriangulateCmd::doIt(const MArgList& args)
+{
+    MStatus status;
+    MArgDatabase argData(syntax(), args, &status);
+    CHECK_RETURN_STATUS(status)
+    // -mesh: mesh to triangulate, the MeshroomMaya mesh by default
+    MString meshName(MVGProject::_MESH.c_str());
+    if(argData.isFlagSet(meshFlag))
+        argData.getFlagArgument(meshFlag, 0, meshName);
+    MVGMesh mesh(meshName);
+    if(!mesh.isValid())
+    {
+        LOG_ERROR("Mesh is not valid : " << meshName)
+        return MS::kFailure;
+    }
+
+    // read all the placed points at once
+    std::vector<int> vertexIds;
+    std::vector<std::vector<MVGMesh::ClickedCSPosition> > clickedCSPositions;
+    status = mesh.getAllBlindData(vertexIds, clickedCSPositions);
+    CHECK_RETURN_STATUS(status)
+
+    // projections of all the cameras, and vertices placed in at least 2 of them
+    typedef std::map<int, const MVGProjectionCache::CameraProjection*> ProjectionMap;
+    ProjectionMap projections;
+    std::vector<size_t> constrainedVertices;
+    for(size_t i = 0; i < clickedCSPositions.size(); ++i)
+    {
+        size_t viewsCount = 0;
+        for(size_t j = 0; j < clickedCSPositions[i].size(); ++j)
+        {
+            const int cameraId = clickedCSPositions[i][j].cameraId;
+            ProjectionMap::iterator it = projections.find(cameraId);
+            if(it == projections.end())
+                it = projections
+                         .insert(std::make_pair(cameraId,
+                                                MVGProjectionCache::getProjection(cameraId)))
+                         .first;
+            if(it->second)
+                ++viewsCount;
+        }
+        if(viewsCount > 1)
+            constrainedVertices.push_back(i);
+    }
+
+    // triangulate, without calling Maya
+    const size_t count = constrainedVertices.size();
+    size_t threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadsCount = std::max<size_t>(std::min(threadsCount, count / MIN_VERTICES_PER_THREAD), 1);
+    std::vector<aliceVision::Vec3> positions(count);
+    std::vector<char> isTriangulated(count, 0);
+    parallelForChunks(
+        threadsCount, count, [&](const size_t chunk, const size_t begin, const size_t end)
+        {
+            MVGPointTriangulator triangulator;
+            std::vector<aliceVision::Mat34> cameras;
+            aliceVision::Mat2X imagePoints;
+            for(size_t i = begin; i < end; ++i)
+            {
+                const std::vector<MVGMesh::ClickedCSPosition>& clicked =
+                    clickedCSPositions[constrainedVertices[i]];
+                cameras.clear();
+                imagePoints.resize(2, clicked.size());
+                for(size_t j = 0; j < clicked.size(); ++j)
+                {
+                    const MVGProjectionCache::CameraProjection* projection =
+                        projections.find(clicked[j].cameraId)->second;
+                    if(!projection)
+                        continue;
+                    imagePoints.col(cameras.size()) =
+                        projection->cameraToImageSpace(MPoint(clicked[j].x, clicked[j].y));
+                    cameras.push_back(projection->P);
+                }
+                imagePoints.conservativeResize(2, cameras.size());
+                // vertices are independent, do not start from the previous one
+                triangulator.clear();
+                isTriangulated[i] = triangulator.triangulate(cameras, imagePoints, positions[i]);
+            }
+        });
+
+    MIntArray componentIDs;
+    MPointArray worldPositions;
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(!isTriangulated[i])
+            continue;
+        componentIDs.append(vertexIds[constrainedVertices[i]]);
+        worldPositions.append(MPoint(positions[i](0), positions[i](1), positions[i](2)));
+    }
+    if(componentIDs.length() == 0)
+    {
+        setResult(0);
+        return MS::kSuccess;
+    }
+    if(componentIDs.length() < count)
+        LOG_WARNING(count - componentIDs.length() << " vertices can't be triangulated")
+
+    setPoints(mesh.getDagPath(), componentIDs, worldPositions);
+    status = MVGEditCmd::doIt(args);
+    CHECK_RETURN_STATUS(status)
+    _hasEdit = true;
+    setResult(static_cast<int>(componentIDs.length()));
+    return status;
+}
+
+bool MVGRetriangulateCmd::isUndoable() const
+{
+    return _hasEdit;
+}
+
+} // namespace
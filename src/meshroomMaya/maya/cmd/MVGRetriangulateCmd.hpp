@@ -0,0 +1,37 @@
+#pragma once
+
+#include "meshroomMaya/maya/cmd/MVGEditCmd.hpp"
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Triangulate again all the vertices of a mesh from their placed 2D points.
+ *
+ * Needed once cameras have moved, or after importing blind data: vertices are otherwise only
+ * triangulated when dragged. Vertices placed in less than 2 views are left untouched. The new
+ * positions are applied as a single MVGEditCmd edit, and undone as such.
+ */
+class MVGRetriangulateCmd : public MVGEditCmd
+{
+
+public:
+    MVGRetriangulateCmd();
+    virtual ~MVGRetriangulateCmd();
+
+public:
+    static void* creator();
+    static MSyntax newSyntax();
+    virtual bool hasSyntax() const { return true; }
+    virtual MStatus doIt(const MArgList& args);
+    virtual bool isUndoable() const;
+
+public:
+    static MString _name;
+
+private:
+    /// false if no vertex has been moved
+    bool _hasEdit;
+};
+
+} // namespace
@@ -121,7 +121,6 @@ bool MVGContext::eventFilter(QObject* obj, QEvent* e)
                         if(cmd->doIt(args))
                         {
                             cmd->finalize();
-                            _manipulatorCache.rebuildMeshesCache();
                             _manipulatorCache.clearSelectedComponent();
                         }
                         break;
@@ -6,9 +6,12 @@
 #include "meshroomMaya/maya/context/MVGMoveManipulator.hpp"
 #include "meshroomMaya/maya/context/MVGLocatorManipulator.hpp"
 #include "meshroomMaya/maya/MVGMayaUtil.hpp"
+#include "meshroomMaya/core/MVGGeometryUtil.hpp"
 #include "meshroomMaya/core/MVGLog.hpp"
 
 #include <maya/MPxManipulatorNode.h>
+#include <maya/MStringArray.h>
+#include <maya/MIntArray.h>
 #include <maya/MUserEventMessage.h>
 
 
@@ -19,10 +22,18 @@ static const char* rebuildFlag = "-r";
 static const char* rebuildFlagLong = "-rebuild";
 static const char* meshFlag = "-m";
 static const char* meshFlagLong = "-mesh";
+static const char* verticesFlag = "-vx";
+static const char* verticesFlagLong = "-vertices";
 static const char* editModeFlag = "-em";
 static const char* editModeFlagLong = "-editMode";
 static const char* moveModeFlag = "-mv";
 static const char* moveModeFlagLong = "-moveMode";
+static const char* planeEstimatorFlag = "-pe";
+static const char* planeEstimatorFlagLong = "-planeEstimator";
+static const char* planeIterationsFlag = "-pi";
+static const char* planeIterationsFlagLong = "-planeIterations";
+static const char* planeResidualRatioFlag = "-pr";
+static const char* planeResidualRatioFlagLong = "-planeResidualRatio";
 
 } // empty namespace
 
@@ -60,6 +71,19 @@ MStatus MVGContextCmd::doEditFlags()
             MString meshName;
             argData.getFlagArgument(meshFlag, 0, meshName);
             MVGMesh mesh(meshName);
+            // -vertices: only update the given vertices (space separated ids)
+            if(argData.isFlagSet(verticesFlag))
+            {
+                MString verticesString;
+                argData.getFlagArgument(verticesFlag, 0, verticesString);
+                MStringArray verticesStrings;
+                verticesString.split(' ', verticesStrings);
+                MIntArray vertexIDs;
+                for(size_t i = 0; i < verticesStrings.length(); ++i)
+                    vertexIDs.append(verticesStrings[i].asInt());
+                cache.updateMeshCache(mesh.getDagPath(), vertexIDs);
+                return MS::kSuccess;
+            }
             cache.rebuildMeshCache(mesh.getDagPath());
             return MS::kSuccess;
         }
@@ -148,6 +172,44 @@ MStatus MVGContextCmd::doEditFlags()
            MVGMoveManipulator::_mode == MVGMoveManipulator::eMoveModePointCloudProjection)
             _context->getCache().clearSelectedComponent();
     }
+    // -planeEstimator: robust estimator of the point cloud planes (see MVGPlaneEstimatorOptions)
+    if(argData.isFlagSet(planeEstimatorFlag))
+    {
+        int method = 0;
+        argData.getFlagArgument(planeEstimatorFlag, 0, method);
+        if(method < MVGPlaneEstimatorOptions::eMethodLMedS ||
+           method > MVGPlaneEstimatorOptions::eMethodProsac)
+        {
+            LOG_ERROR("Unknown plane estimator " << method)
+            return MS::kFailure;
+        }
+        MVGGeometryUtil::_planeEstimatorOptions.method =
+            static_cast<MVGPlaneEstimatorOptions::EMethod>(method);
+    }
+    // -planeIterations: iteration budget of the RANSAC plane estimators
+    if(argData.isFlagSet(planeIterationsFlag))
+    {
+        int iterations = 0;
+        argData.getFlagArgument(planeIterationsFlag, 0, iterations);
+        if(iterations <= 0)
+        {
+            LOG_ERROR("planeIterations must be positive")
+            return MS::kFailure;
+        }
+        MVGGeometryUtil::_planeEstimatorOptions.maxIterations = iterations;
+    }
+    // -planeResidualRatio: planarity under which the moved face keeps its incremental plane
+    if(argData.isFlagSet(planeResidualRatioFlag))
+    {
+        double ratio = 0.0;
+        argData.getFlagArgument(planeResidualRatioFlag, 0, ratio);
+        if(ratio <= 0.0)
+        {
+            LOG_ERROR("planeResidualRatio must be positive")
+            return MS::kFailure;
+        }
+        MVGMoveManipulator::_planeMaxResidualRatio = ratio;
+    }
     MUserEventMessage::postUserEvent("modeChangedEvent");
     return MS::kSuccess;
 }
@@ -160,6 +222,12 @@ MStatus MVGContextCmd::doQueryFlags()
         setResult((int)_context->getEditMode());
     if(argData.isFlagSet(moveModeFlag))
         setResult((int)MVGMoveManipulator::_mode);
+    if(argData.isFlagSet(planeEstimatorFlag))
+        setResult((int)MVGGeometryUtil::_planeEstimatorOptions.method);
+    if(argData.isFlagSet(planeIterationsFlag))
+        setResult((int)MVGGeometryUtil::_planeEstimatorOptions.maxIterations);
+    if(argData.isFlagSet(planeResidualRatioFlag))
+        setResult(MVGMoveManipulator::_planeMaxResidualRatio);
     return MS::kSuccess;
 }
 
@@ -170,10 +238,20 @@ MStatus MVGContextCmd::appendSyntax()
         return MS::kFailure;
     if(MS::kSuccess != mySyntax.addFlag(meshFlag, meshFlagLong, MSyntax::kString))
         return MS::kFailure;
+    if(MS::kSuccess != mySyntax.addFlag(verticesFlag, verticesFlagLong, MSyntax::kString))
+        return MS::kFailure;
     if(MS::kSuccess != mySyntax.addFlag(editModeFlag, editModeFlagLong, MSyntax::kString))
         return MS::kFailure;
     if(MS::kSuccess != mySyntax.addFlag(moveModeFlag, moveModeFlagLong, MSyntax::kString))
         return MS::kFailure;
+    if(MS::kSuccess != mySyntax.addFlag(planeEstimatorFlag, planeEstimatorFlagLong, MSyntax::kLong))
+        return MS::kFailure;
+    if(MS::kSuccess !=
+       mySyntax.addFlag(planeIterationsFlag, planeIterationsFlagLong, MSyntax::kLong))
+        return MS::kFailure;
+    if(MS::kSuccess !=
+       mySyntax.addFlag(planeResidualRatioFlag, planeResidualRatioFlagLong, MSyntax::kDouble))
+        return MS::kFailure;
     return MS::kSuccess;
 }
 
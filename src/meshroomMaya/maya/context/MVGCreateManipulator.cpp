@@ -155,7 +155,7 @@ MStatus MVGCreateManipulator::doPress(M3dView& view)
     if(_cache->getActiveCamera().getId() != _cameraID)
     {
         _cameraID = _cache->getActiveCamera().getId();
-        _cache->getActiveCamera().getVisibleItems(_visiblePointCloudItems);
+        _cache->getActiveCamera().getVisibleItems(_visiblePointCloudItems.edit());
     }
     // set this view as the active view
     _cache->setActiveView(view);
@@ -230,10 +230,7 @@ MStatus MVGCreateManipulator::doRelease(M3dView& view)
 
     MArgList args;
     if(cmd->doIt(args))
-    {
         cmd->finalize();
-        _cache->rebuildMeshCache(_onPressIntersectedComponent.meshPath);
-    }
 
     // Clear data
     _onPressIntersectedComponent = MVGManipulatorCache::MVGComponent();
@@ -285,7 +282,8 @@ void MVGCreateManipulator::computeFinalWSPoints(M3dView& view)
         previewCSPoints.append(getMousePosition(view));
         // project clicked points on point cloud
         MVGPointCloud cloud(MVGProject::_CLOUD);
-        cloud.projectPoints(view, _visiblePointCloudItems, previewCSPoints, _finalWSPoints);
+        cloud.projectPoints(view, _visiblePointCloudItems, _visiblePointCloudIndex, previewCSPoints,
+                            _finalWSPoints);
         return;
     }
     if(_cameraIDToClickedCSPoints.second.length() > 0)
@@ -342,7 +340,8 @@ bool MVGCreateManipulator::computePCPoints(M3dView& view, MPointArray& finalWSPo
     MPointArray constraintedPoints;
     constraintedPoints.append(_onPressIntersectedComponent.edge->vertex1->worldPosition);
     constraintedPoints.append(_onPressIntersectedComponent.edge->vertex2->worldPosition);
-    if(!cloud.projectPointsWithLineConstraint(view, _visiblePointCloudItems, cameraSpacePoints,
+    if(!cloud.projectPointsWithLineConstraint(view, _visiblePointCloudItems,
+                                              _visiblePointCloudIndex, cameraSpacePoints,
                                               constraintedPoints, getMousePosition(view),
                                               projectedMouseWS))
         return false;
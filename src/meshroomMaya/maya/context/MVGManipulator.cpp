@@ -50,7 +50,7 @@ void MVGManipulator::getIntersectedPoints(M3dView& view, MPointArray& positions,
         case MFn::kBlindData:
         {
             MPoint pointCSPosition =
-                intersectedComponent.vertex->blindData[_cache->getActiveCamera().getId()];
+                intersectedComponent.vertex->blindData.at(_cache->getActiveCamera().getId());
             intersectedPositions.append(MVGGeometryUtil::cameraToWorldSpace(view, pointCSPosition));
             break;
         }
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "meshroomMaya/core/MVGGeometryUtil.hpp"
-#include "meshroomMaya/core/MVGPointCloudItem.hpp"
+#include "meshroomMaya/core/MVGPointCloudIndex.hpp"
 #include "meshroomMaya/maya/context/MVGManipulatorCache.hpp"
 #include "meshroomMaya/maya/context/MVGContext.hpp"
 #include "meshroomMaya/maya/cmd/MVGEditCmd.hpp"
@@ -64,7 +64,8 @@ protected:
     MPoint _onPressCSPoint;
     MPointArray _finalWSPoints;
     int _cameraID;
-    std::vector<MVGPointCloudItem> _visiblePointCloudItems;
+    MVGPointCloudItemList _visiblePointCloudItems;
+    MVGPointCloudIndex _visiblePointCloudIndex;
     MIntArray _snapedPoints;
     bool _doDrag;
 
@@ -7,7 +7,9 @@
 #include <maya/MItMeshVertex.h>
 #include <maya/MItMeshEdge.h>
 
+#include <algorithm>
 #include <list>
+#include <limits>
 
 namespace meshroomMaya
 {
@@ -32,6 +34,25 @@ float minimumDistanceToEdge(MPoint A, MPoint B, MPoint P)
     return P.distanceTo(projection);
 }
 
+void readVertexData(MItMeshVertex& vIt, const MVGMesh& mesh,
+                    MVGManipulatorCache::VertexData& vertex)
+{
+    MStatus status;
+    vertex = MVGManipulatorCache::VertexData();
+    vertex.index = vIt.index(&status);
+    CHECK(status)
+    CHECK(vIt.numConnectedEdges(vertex.numConnectedEdges))
+    vertex.worldPosition = vIt.position(MSpace::kWorld, &status);
+    // blind data
+    std::vector<MVGMesh::ClickedCSPosition> clickedCSPositions;
+    if(!mesh.getBlindData(vertex.index, clickedCSPositions))
+        return;
+    vertex.blindData.reserve(clickedCSPositions.size());
+    std::vector<MVGMesh::ClickedCSPosition>::const_iterator it = clickedCSPositions.begin();
+    for(; it != clickedCSPositions.end(); ++it)
+        vertex.blindData[it->cameraId] = MPoint(it->x, it->y);
+}
+
 } // empty namespace
 
 MVGManipulatorCache::MVGManipulatorCache()
@@ -170,14 +191,7 @@ void MVGManipulatorCache::rebuildMeshCache(const MDagPath& path)
     {
         int index = vIt.index(&status);
         CHECK(status)
-        int numConnectedEdges = -1;
-        CHECK(vIt.numConnectedEdges(numConnectedEdges))
-        // blind data
-        VertexData& vertex = newMeshData.vertices[index];
-        vertex.index = index;
-        vertex.numConnectedEdges = numConnectedEdges;
-        vertex.worldPosition = vIt.position(MSpace::kWorld, &status);
-        mesh.getBlindData(index, vertex.blindData);
+        readVertexData(vIt, mesh, newMeshData.vertices[index]);
         vIt.next();
     }
     // fill it w/ edges data
@@ -200,15 +214,160 @@ void MVGManipulatorCache::rebuildMeshCache(const MDagPath& path)
         updateSelectedComponent(meshPath, type, index);
 }
 
+/**
+ * Patch the cache of a mesh after an edit made by the plugin, without iterating over the whole
+ * mesh. Vertices and edges appended by the edit are detected from the vertices & edges counts.
+ * Only trailing vertices and edges may be appended or removed (the plugin edits add faces, or
+ * undo that): the whole mesh cache is rebuilt if the kept edges have been renumbered.
+ *
+ * @param path : path of the edited mesh
+ * @param vertexIDs : ids of the vertices whose position, connectivity or blind data changed
+ */
+void MVGManipulatorCache::updateMeshCache(const MDagPath& path, const MIntArray& vertexIDs)
+{
+    if(!path.isValid())
+        return;
+    MVGMesh mesh(path);
+    std::map<std::string, MeshData>::iterator meshIt =
+        _meshData.find(path.fullPathName().asChar());
+    if(meshIt == _meshData.end() || !mesh.isActive())
+    {
+        rebuildMeshCache(path);
+        return;
+    }
+    MeshData& meshData = meshIt->second;
+
+    // prepare vertices & edges iterators
+    MStatus status;
+    MItMeshVertex vIt(path, MObject::kNullObj, &status);
+    vIt.updateSurface();
+    vIt.geomChanged();
+    CHECK_RETURN(status)
+    MItMeshEdge eIt(path, MObject::kNullObj, &status);
+    eIt.updateSurface();
+    eIt.geomChanged();
+    CHECK_RETURN(status)
+    const size_t oldVerticesCount = meshData.vertices.size();
+    const size_t oldEdgesCount = meshData.edges.size();
+    const size_t verticesCount = vIt.count();
+    const size_t edgesCount = eIt.count();
+    const size_t keptEdgesCount = std::min(oldEdgesCount, edgesCount);
+    if(edgesCount != oldEdgesCount && keptEdgesCount > 0)
+    {
+        // trailing edges appended or removed only: the last kept edge must be unchanged
+        int prevIndex;
+        const EdgeData& lastEdge = meshData.edges[keptEdgesCount - 1];
+        CHECK(eIt.setIndex(keptEdgesCount - 1, prevIndex))
+        if(eIt.index(0) != lastEdge.vertex1->index || eIt.index(1) != lastEdge.vertex2->index)
+        {
+            rebuildMeshCache(path);
+            return;
+        }
+    }
+    // a kept edge using a removed vertex: not a trailing removal
+    for(size_t i = 0; verticesCount < oldVerticesCount && i < keptEdgesCount; ++i)
+    {
+        const EdgeData& edge = meshData.edges[i];
+        if(static_cast<size_t>(std::max(edge.vertex1->index, edge.vertex2->index)) >=
+           verticesCount)
+        {
+            rebuildMeshCache(path);
+            return;
+        }
+    }
+
+    // vertices to read again: the edited ones still existing and the appended ones
+    std::vector<int> updatedIDs;
+    updatedIDs.reserve(vertexIDs.length());
+    for(size_t i = 0; i < vertexIDs.length(); ++i)
+    {
+        if(vertexIDs[i] >= 0 &&
+           static_cast<size_t>(vertexIDs[i]) < std::min(oldVerticesCount, verticesCount))
+            updatedIDs.push_back(vertexIDs[i]);
+    }
+    for(size_t i = oldVerticesCount; i < verticesCount; ++i)
+        updatedIDs.push_back(i);
+    std::sort(updatedIDs.begin(), updatedIDs.end());
+    updatedIDs.erase(std::unique(updatedIDs.begin(), updatedIDs.end()), updatedIDs.end());
+
+    if(verticesCount != oldVerticesCount || edgesCount != oldEdgesCount)
+    {
+        // Topology changed: component pointers are about to be invalidated
+        MDagPath meshPath = _selectedComponent.meshPath;
+        MFn::Type type = MFn::kInvalid;
+        int index = -1;
+        if(meshPath == path)
+        {
+            type = _selectedComponent.type;
+            if(type == MFn::kBlindData || type == MFn::kMeshVertComponent)
+                index = _selectedComponent.vertex->index;
+            if(type == MFn::kMeshEdgeComponent)
+                index = _selectedComponent.edge->index;
+            clearSelectedComponent();
+        }
+        if(path == _intersectedComponent.meshPath)
+            clearIntersectedComponent();
+
+        // resize vertices, then link the kept edges to the (possibly moved) vertices
+        std::vector<int> edgeVertexIDs(2 * keptEdgesCount);
+        for(size_t i = 0; i < keptEdgesCount; ++i)
+        {
+            edgeVertexIDs[2 * i] = meshData.edges[i].vertex1->index;
+            edgeVertexIDs[2 * i + 1] = meshData.edges[i].vertex2->index;
+        }
+        meshData.vertices.resize(verticesCount);
+        meshData.edges.resize(edgesCount);
+        for(size_t i = 0; i < keptEdgesCount; ++i)
+        {
+            meshData.edges[i].vertex1 = &meshData.vertices[edgeVertexIDs[2 * i]];
+            meshData.edges[i].vertex2 = &meshData.vertices[edgeVertexIDs[2 * i + 1]];
+        }
+        // fill appended edges
+        int prevIndex;
+        for(size_t i = oldEdgesCount; i < edgesCount; ++i)
+        {
+            CHECK(eIt.setIndex(i, prevIndex))
+            assert(eIt.index(0) < verticesCount);
+            assert(eIt.index(1) < verticesCount);
+            EdgeData& edge = meshData.edges[i];
+            edge.index = i;
+            edge.vertex1 = &meshData.vertices[eIt.index(0)];
+            edge.vertex2 = &meshData.vertices[eIt.index(1)];
+        }
+
+        if(meshPath == path)
+            updateSelectedComponent(meshPath, type, index);
+    }
+
+    // read edited & appended vertices
+    int prevIndex;
+    for(std::vector<int>::const_iterator it = updatedIDs.begin(); it != updatedIDs.end(); ++it)
+    {
+        CHECK(vIt.setIndex(*it, prevIndex))
+        readVertexData(vIt, mesh, meshData.vertices[*it]);
+    }
+
+    // update camera space positions, picking grids will be rebuilt on demand
+    std::map<int, CameraData>::iterator cameraIt = meshData.cameraData.begin();
+    for(; cameraIt != meshData.cameraData.end(); ++cameraIt)
+    {
+        CameraData& cameraData = cameraIt->second;
+        cameraData.cameraSpacePoints.resize(verticesCount);
+        for(std::vector<int>::const_iterator it = updatedIDs.begin(); it != updatedIDs.end(); ++it)
+            MVGGeometryUtil::worldToCameraSpace(cameraData.transform,
+                                                meshData.vertices[*it].worldPosition,
+                                                cameraData.cameraSpacePoints[*it]);
+        cameraData.vertices.clear();
+        cameraData.edges.clear();
+        cameraData.blindData.clear();
+    }
+}
+
 void MVGManipulatorCache::checkForCameraSpacePositions(M3dView& view, MeshData& meshData,
                                                        const int cameraID)
 {
-    if(meshData.vertices.empty())
-        return;
-    std::map<int, MPoint>& cameraSpacePoints = meshData.vertices.begin()->cameraSpacePoints;
-    std::map<int, MPoint>::iterator cameraIt = cameraSpacePoints.find(cameraID);
     // We compute position only if there are not in the cache to avoid computing them all the time
-    if(cameraIt == cameraSpacePoints.end())
+    if(meshData.cameraData.find(cameraID) == meshData.cameraData.end())
         computeMeshCacheForCameraID(view, meshData, cameraID);
 }
 
@@ -217,35 +376,28 @@ void MVGManipulatorCache::checkForCameraSpacePositions(M3dView& view, MeshData&
  * @param view
  * @param meshData
  * @param cameraID
- * @brief Compute camera space coordinates and add it to mesh cache
+ * @brief Compute camera space coordinates of all vertices and add it to mesh cache
  */
 void MVGManipulatorCache::computeMeshCacheForCameraID(M3dView& view, MeshData& meshData,
                                                       const int cameraID)
 {
-    std::vector<VertexData>& vertices = meshData.vertices;
-    for(std::vector<VertexData>::iterator vertexIt = vertices.begin(); vertexIt != vertices.end();
-        ++vertexIt)
-    {
-        // Add new camera
-        std::map<int, MPoint>& cameraSpacePoints = vertexIt->cameraSpacePoints;
-        cameraSpacePoints[cameraID] =
-            MVGGeometryUtil::worldToCameraSpace(view, vertexIt->worldPosition);
-    }
+    const MVGGeometryUtil::ViewTransform transform(view);
+    CameraData& cameraData = meshData.cameraData[cameraID];
+    cameraData = CameraData();
+    cameraData.transform = transform;
+    const std::vector<VertexData>& vertices = meshData.vertices;
+    std::vector<MPoint>& cameraSpacePoints = cameraData.cameraSpacePoints;
+    cameraSpacePoints.resize(vertices.size());
+    for(size_t i = 0; i < vertices.size(); ++i)
+        MVGGeometryUtil::worldToCameraSpace(transform, vertices[i].worldPosition,
+                                            cameraSpacePoints[i]);
 }
 
 void MVGManipulatorCache::removeMeshCacheForCameraID(const int cameraID)
 {
     for(std::map<std::string, MeshData>::iterator meshIt = _meshData.begin();
         meshIt != _meshData.end(); ++meshIt)
-    {
-        std::vector<VertexData>& vertices = meshIt->second.vertices;
-        for(std::vector<VertexData>::iterator vertexIt = vertices.begin();
-            vertexIt != vertices.end(); ++vertexIt)
-        {
-            std::map<int, MPoint>& cameraSpacePoints = vertexIt->cameraSpacePoints;
-            cameraSpacePoints.erase(cameraID);
-        }
-    }
+        meshIt->second.cameraData.erase(cameraID);
 }
 
 void MVGManipulatorCache::setSelectedComponent(const MVGComponent& selectedComponent)
@@ -282,6 +434,43 @@ void MVGManipulatorCache::updateSelectedComponent(const MDagPath& meshPath, cons
     _selectedComponent = component;
 }
 
+/**
+ * Retrieve the camera relative data of a mesh, computing positions and picking grids if needed.
+ */
+const MVGManipulatorCache::CameraData& MVGManipulatorCache::getCameraData(MeshData& meshData,
+                                                                         const int cameraID)
+{
+    checkForCameraSpacePositions(_activeView, meshData, cameraID);
+    CameraData& cameraData = meshData.cameraData[cameraID];
+    if(cameraData.vertices.isBuilt())
+        return cameraData;
+
+    const std::vector<MPoint>& cameraSpacePoints = cameraData.cameraSpacePoints;
+    std::vector<MVGPickingGrid::Box> vertexBoxes;
+    std::vector<MVGPickingGrid::Box> blindDataBoxes;
+    vertexBoxes.reserve(meshData.vertices.size());
+    std::vector<VertexData>::const_iterator vertexIt = meshData.vertices.begin();
+    for(; vertexIt != meshData.vertices.end(); ++vertexIt)
+    {
+        vertexBoxes.push_back(
+            MVGPickingGrid::Box(cameraSpacePoints[vertexIt->index], vertexIt->index));
+        BlindData::const_iterator blindDataIt = vertexIt->blindData.find(cameraID);
+        if(blindDataIt != vertexIt->blindData.end())
+            blindDataBoxes.push_back(MVGPickingGrid::Box(blindDataIt->second, vertexIt->index));
+    }
+    std::vector<MVGPickingGrid::Box> edgeBoxes;
+    edgeBoxes.reserve(meshData.edges.size());
+    std::vector<EdgeData>::const_iterator edgeIt = meshData.edges.begin();
+    for(; edgeIt != meshData.edges.end(); ++edgeIt)
+        edgeBoxes.push_back(MVGPickingGrid::Box(cameraSpacePoints[edgeIt->vertex1->index],
+                                                cameraSpacePoints[edgeIt->vertex2->index],
+                                                edgeIt->index));
+    cameraData.vertices.build(vertexBoxes);
+    cameraData.blindData.build(blindDataBoxes);
+    cameraData.edges.build(edgeBoxes);
+    return cameraData;
+}
+
 bool MVGManipulatorCache::isIntersectingBlindData(const double tolerance,
                                                   const MPoint& mouseCSPosition)
 {
@@ -291,35 +480,45 @@ bool MVGManipulatorCache::isIntersectingBlindData(const double tolerance,
     const double threshold =
         (tolerance * _activeCamera.getZoom()) / (double)_activeView.portWidth();
     const int cameraID = _activeCamera.getId();
-    // check each mesh vertices
+    // look for the closest blind data position in each mesh
+    std::map<std::string, MeshData>::iterator closestMeshIt = _meshData.end();
+    VertexData* closestVertex = NULL;
+    double closestDistance = std::numeric_limits<double>::max();
+    std::vector<int> candidates;
     std::map<std::string, MeshData>::iterator meshIt = _meshData.begin();
     for(; meshIt != _meshData.end(); ++meshIt)
     {
-        std::vector<VertexData>& vertices = meshIt->second.vertices;
-        std::vector<VertexData>::iterator vertexIt = vertices.begin();
-        for(; vertexIt < vertices.end(); ++vertexIt)
+        const CameraData& cameraData = getCameraData(meshIt->second, cameraID);
+        cameraData.blindData.getCandidates(mouseCSPosition, threshold, candidates);
+        std::vector<int>::const_iterator it = candidates.begin();
+        for(; it != candidates.end(); ++it)
         {
-            std::map<int, MPoint>::const_iterator blindDataIt = vertexIt->blindData.find(cameraID);
-            if(blindDataIt == vertexIt->blindData.end())
-                continue;
-            MPoint pointCSPosition = blindDataIt->second;
+            VertexData& vertex = meshIt->second.vertices[*it];
+            const MPoint& pointCSPosition = vertex.blindData.at(cameraID);
             // check if we intersect w/ the vertex position
             if(mouseCSPosition.x <= pointCSPosition.x + threshold &&
                mouseCSPosition.x >= pointCSPosition.x - threshold &&
                mouseCSPosition.y <= pointCSPosition.y + threshold &&
                mouseCSPosition.y >= pointCSPosition.y - threshold)
             {
-                MDagPath meshPath;
-                MVGMayaUtil::getDagPathByName(meshIt->first.c_str(), meshPath);
-                _intersectedComponent.type = MFn::kBlindData;
-                _intersectedComponent.meshPath = meshPath;
-                _intersectedComponent.vertex = &(*vertexIt);
-                _intersectedComponent.edge = NULL;
-                return true;
+                const double distance = mouseCSPosition.distanceTo(pointCSPosition);
+                if(distance >= closestDistance)
+                    continue;
+                closestDistance = distance;
+                closestMeshIt = meshIt;
+                closestVertex = &vertex;
             }
         }
     }
-    return false;
+    if(!closestVertex)
+        return false;
+    MDagPath meshPath;
+    MVGMayaUtil::getDagPathByName(closestMeshIt->first.c_str(), meshPath);
+    _intersectedComponent.type = MFn::kBlindData;
+    _intersectedComponent.meshPath = meshPath;
+    _intersectedComponent.vertex = closestVertex;
+    _intersectedComponent.edge = NULL;
+    return true;
 }
 
 bool MVGManipulatorCache::isIntersectingPoint(const double tolerance, const MPoint& mouseCSPosition)
@@ -330,37 +529,45 @@ bool MVGManipulatorCache::isIntersectingPoint(const double tolerance, const MPoi
     double threshold = (tolerance * _activeCamera.getZoom()) / (double)_activeView.portWidth();
 
     int cameraID = _activeCamera.getId();
-    // check each mesh vertice
+    // look for the closest vertex in each mesh
+    std::map<std::string, MeshData>::iterator closestMeshIt = _meshData.end();
+    VertexData* closestVertex = NULL;
+    double closestDistance = std::numeric_limits<double>::max();
+    std::vector<int> candidates;
     std::map<std::string, MeshData>::iterator meshIt = _meshData.begin();
     for(; meshIt != _meshData.end(); ++meshIt)
     {
-        // Check for cameraSpace coordinates
-        // We compute position only if there are not in the cache to avoid computing them all the
-        // time
-        checkForCameraSpacePositions(_activeView, meshIt->second, cameraID);
-
-        std::vector<VertexData>& vertices = meshIt->second.vertices;
-        std::vector<VertexData>::iterator vertexIt = vertices.begin();
-        for(; vertexIt < vertices.end(); ++vertexIt)
+        const CameraData& cameraData = getCameraData(meshIt->second, cameraID);
+        cameraData.vertices.getCandidates(mouseCSPosition, threshold, candidates);
+        std::vector<int>::const_iterator it = candidates.begin();
+        for(; it != candidates.end(); ++it)
         {
             // check if we intersect w/ the real vertex position projection
-            MPoint& realCSVertexPosition = vertexIt->cameraSpacePoints[cameraID];
+            VertexData& vertex = meshIt->second.vertices[*it];
+            const MPoint& realCSVertexPosition = cameraData.cameraSpacePoints[*it];
             if(mouseCSPosition.x <= realCSVertexPosition.x + threshold &&
                mouseCSPosition.x >= realCSVertexPosition.x - threshold &&
                mouseCSPosition.y <= realCSVertexPosition.y + threshold &&
                mouseCSPosition.y >= realCSVertexPosition.y - threshold)
             {
-                MDagPath meshPath;
-                MVGMayaUtil::getDagPathByName(meshIt->first.c_str(), meshPath);
-                _intersectedComponent.type = MFn::kMeshVertComponent;
-                _intersectedComponent.meshPath = meshPath;
-                _intersectedComponent.vertex = &(*vertexIt);
-                _intersectedComponent.edge = NULL;
-                return true;
+                const double distance = mouseCSPosition.distanceTo(realCSVertexPosition);
+                if(distance >= closestDistance)
+                    continue;
+                closestDistance = distance;
+                closestMeshIt = meshIt;
+                closestVertex = &vertex;
             }
         }
     }
-    return false;
+    if(!closestVertex)
+        return false;
+    MDagPath meshPath;
+    MVGMayaUtil::getDagPathByName(closestMeshIt->first.c_str(), meshPath);
+    _intersectedComponent.type = MFn::kMeshVertComponent;
+    _intersectedComponent.meshPath = meshPath;
+    _intersectedComponent.vertex = closestVertex;
+    _intersectedComponent.edge = NULL;
+    return true;
 }
 
 bool MVGManipulatorCache::isIntersectingEdge(const double tolerance, const MPoint& mouseCSPosition)
@@ -371,35 +578,40 @@ bool MVGManipulatorCache::isIntersectingEdge(const double tolerance, const MPoin
     double threshold = (tolerance * _activeCamera.getZoom()) / (double)_activeView.portWidth();
 
     int cameraID = _activeCamera.getId();
-    // check each mesh edges
+    // look for the closest edge in each mesh
+    std::map<std::string, MeshData>::iterator closestMeshIt = _meshData.end();
+    EdgeData* closestEdge = NULL;
+    double closestDistance = threshold;
+    std::vector<int> candidates;
     std::map<std::string, MeshData>::iterator meshIt = _meshData.begin();
     for(; meshIt != _meshData.end(); ++meshIt)
     {
-        // Check for cameraSpace coordinates
-        // We compute position only if there are not in the cache to avoid computing them all the
-        // time
-        checkForCameraSpacePositions(_activeView, meshIt->second, cameraID);
-
-        std::vector<EdgeData>& edges = meshIt->second.edges;
-        std::vector<EdgeData>::iterator edgeIt = edges.begin();
-        for(; edgeIt < edges.end(); ++edgeIt)
+        const CameraData& cameraData = getCameraData(meshIt->second, cameraID);
+        cameraData.edges.getCandidates(mouseCSPosition, threshold, candidates);
+        std::vector<int>::const_iterator it = candidates.begin();
+        for(; it != candidates.end(); ++it)
         {
-            MPoint& vertex1CSPosition = edgeIt->vertex1->cameraSpacePoints[cameraID];
-            MPoint& vertex2CSPosition = edgeIt->vertex2->cameraSpacePoints[cameraID];
-            if(minimumDistanceToEdge(vertex1CSPosition, vertex2CSPosition, mouseCSPosition) <
-               threshold)
-            {
-                MDagPath meshPath;
-                MVGMayaUtil::getDagPathByName(meshIt->first.c_str(), meshPath);
-                _intersectedComponent.type = MFn::kMeshEdgeComponent;
-                _intersectedComponent.meshPath = meshPath;
-                _intersectedComponent.vertex = NULL;
-                _intersectedComponent.edge = &(*edgeIt);
-                return true;
-            }
+            EdgeData& edge = meshIt->second.edges[*it];
+            const double distance =
+                minimumDistanceToEdge(cameraData.cameraSpacePoints[edge.vertex1->index],
+                                      cameraData.cameraSpacePoints[edge.vertex2->index],
+                                      mouseCSPosition);
+            if(distance >= closestDistance)
+                continue;
+            closestDistance = distance;
+            closestMeshIt = meshIt;
+            closestEdge = &edge;
         }
     }
-    return false;
+    if(!closestEdge)
+        return false;
+    MDagPath meshPath;
+    MVGMayaUtil::getDagPathByName(closestMeshIt->first.c_str(), meshPath);
+    _intersectedComponent.type = MFn::kMeshEdgeComponent;
+    _intersectedComponent.meshPath = meshPath;
+    _intersectedComponent.vertex = NULL;
+    _intersectedComponent.edge = closestEdge;
+    return true;
 }
 
 } // namespace
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "meshroomMaya/core/MVGCamera.hpp"
+#include "meshroomMaya/core/MVGGeometryUtil.hpp"
+#include "meshroomMaya/core/MVGPickingGrid.hpp"
+#include "meshroomMaya/core/MVGFlatMap.hpp"
 #include <maya/MDagPath.h>
 #include <maya/MIntArray.h>
 #include <maya/MPointArray.h>
@@ -16,6 +19,9 @@ class MVGContext;
 class MVGManipulatorCache
 {
 public:
+    /// Map from cameraIDs to clickedCSPositions, sorted by camera id
+    typedef MVGFlatMap<int, MPoint> BlindData;
+
     struct VertexData
     {
         VertexData()
@@ -26,10 +32,7 @@ public:
         int index;
         int numConnectedEdges;
         MPoint worldPosition;
-        std::map<int, MPoint> blindData; // map from cameraIDs to clickedCSPositions
-        /// Map from cameraIDs to cameraSpacePositions
-        /// Only store points for the cameras used in the UI.
-        std::map<int, MPoint> cameraSpacePoints;
+        BlindData blindData;
     };
 
     struct EdgeData
@@ -45,10 +48,23 @@ public:
         VertexData* vertex2;
     };
 
+    /// Camera relative data of a mesh.
+    /// Only stored for the cameras used in the UI.
+    struct CameraData
+    {
+        std::vector<MPoint> cameraSpacePoints; // indexed by vertex id
+        MVGGeometryUtil::ViewTransform transform; // used to compute cameraSpacePoints
+        // picking grids, built on demand
+        MVGPickingGrid vertices;  // vertex ids
+        MVGPickingGrid edges;     // edge ids
+        MVGPickingGrid blindData; // ids of the vertices having blind data for this camera
+    };
+
     struct MeshData
     {
         std::vector<VertexData> vertices;
         std::vector<EdgeData> edges;
+        std::map<int, CameraData> cameraData; // per camera id
     };
 
     struct MVGComponent
@@ -85,6 +101,7 @@ public:
     const MeshData& getMeshData(const std::string meshName);
     void rebuildMeshesCache();
     void rebuildMeshCache(const MDagPath&);
+    void updateMeshCache(const MDagPath&, const MIntArray& vertexIDs);
     void checkForCameraSpacePositions(M3dView& view, MeshData& meshData, const int cameraID);
     void computeMeshCacheForCameraID(M3dView& view, MeshData& meshData, const int cameraID);
     void removeMeshCacheForCameraID(const int cameraID);
@@ -95,6 +112,7 @@ public:
     void updateSelectedComponent(const MDagPath& meshPath, const MFn::Type type, const int index);
 
 private:
+    const CameraData& getCameraData(MeshData& meshData, const int cameraID);
     bool isIntersectingBlindData(const double, const MPoint&);
     bool isIntersectingPoint(const double, const MPoint&);
     bool isIntersectingEdge(const double, const MPoint&);
@@ -12,6 +12,8 @@
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MVectorArray.h>
 #include <QApplication>
+#include <iomanip>
+#include <sstream>
 
 namespace meshroomMaya
 {
@@ -20,6 +22,8 @@ MTypeId MVGMoveManipulator::_id(0x99222); // FIXME
 MString MVGMoveManipulator::_drawDbClassification("drawdb/geometry/moveManipulator");
 MString MVGMoveManipulator::_drawRegistrantID("moveManipulatorNode");
 MVGMoveManipulator::EMoveMode MVGMoveManipulator::_mode = eMoveModeNViewTriangulation;
+double MVGMoveManipulator::_planeMaxResidualRatio =
+    MVGIncrementalPlaneFitter::DEFAULT_MAX_RESIDUAL_RATIO;
 
 void* MVGMoveManipulator::creator()
 {
@@ -117,6 +121,9 @@ void MVGMoveManipulator::draw(M3dView& view, const MDagPath& path, M3dView::Disp
             return;
         }
         drawPlacedPoints(view, camera, _cache, _onPressIntersectedComponent);
+        // Draw reprojection errors of the triangulated points
+        if(_doDrag && _mode == eMoveModeNViewTriangulation)
+            drawTriangulationResiduals(view, camera);
         // Draw selected point
         if(!_doDrag)
             drawSelectedPoint2D(view, camera, selectedComponent);
@@ -175,7 +182,7 @@ MStatus MVGMoveManipulator::doPress(M3dView& view)
     if(_cache->getActiveCamera().getId() != _cameraID)
     {
         _cameraID = _cache->getActiveCamera().getId();
-        _cache->getActiveCamera().getVisibleItems(_visiblePointCloudItems);
+        _cache->getActiveCamera().getVisibleItems(_visiblePointCloudItems.edit());
     }
 
     // set this view as the active view
@@ -192,6 +199,10 @@ MStatus MVGMoveManipulator::doPress(M3dView& view)
 
     // store the intersected component
     _onPressIntersectedComponent = _cache->getIntersectedComponent();
+    _planeFitter.clear();
+    _planeFitter.setMaxResidualRatio(_planeMaxResidualRatio);
+    _triangulators[0].clear();
+    _triangulators[1].clear();
 
     // Update selected component
     if(_mode == eMoveModeNViewTriangulation)
@@ -226,7 +237,7 @@ MStatus MVGMoveManipulator::doRelease(M3dView& view)
        selectedComponent.type == MFn::kBlindData)
     {
         // Compute triangulated point with mouse position only if point is not already placed in 2D
-        std::map<int, MPoint>::const_iterator currentData =
+        MVGManipulatorCache::BlindData::const_iterator currentData =
             selectedComponent.vertex->blindData.find(camera.getId());
         if(currentData == selectedComponent.vertex->blindData.end())
             _onPressIntersectedComponent = selectedComponent;
@@ -294,17 +305,14 @@ MStatus MVGMoveManipulator::doRelease(M3dView& view)
                   _cache->getActiveCamera().getId(), clearBD);
         MArgList args;
         if(cmd->doIt(args))
-        {
             cmd->finalize();
-            _cache->rebuildMeshCache(_onPressIntersectedComponent.meshPath);
-        }
     }
 
     // clear the intersected component (stored on mouse press)
     _onPressIntersectedComponent = MVGManipulatorCache::MVGComponent();
     _finalWSPoints.clear();
 
-    // Select after rebuilding cache
+    // Select after updating cache
     if(_mode == eMoveModeNViewTriangulation)
     {
         _cache->checkIntersection(10.0, getMousePosition(view), true);
@@ -407,6 +415,7 @@ void MVGMoveManipulator::computeFinalWSPoints(M3dView& view)
 void MVGMoveManipulator::computeTriangulatedPoints(M3dView& view, MPointArray& finalWSPoints)
 {
     finalWSPoints.clear();
+    _triangulationResiduals.clear();
     MPointArray intermediateCSPositions;
     switch(_onPressIntersectedComponent.type)
     {
@@ -416,7 +425,7 @@ void MVGMoveManipulator::computeTriangulatedPoints(M3dView& view, MPointArray& f
             intermediateCSPositions.append(getMousePosition(view));
             MPoint triangulatedWSPoint;
             if(triangulate(view, _onPressIntersectedComponent.vertex, intermediateCSPositions[0],
-                           triangulatedWSPoint))
+                           _triangulators[0], triangulatedWSPoint))
                 finalWSPoints.append(triangulatedWSPoint);
             break;
         }
@@ -429,13 +438,13 @@ void MVGMoveManipulator::computeTriangulatedPoints(M3dView& view, MPointArray& f
             getIntermediateCSEdgePoints(view, _onPressIntersectedComponent.edge, _onPressCSPoint,
                                         intermediateCSPositions);
             if(triangulate(view, _onPressIntersectedComponent.edge->vertex1,
-                           intermediateCSPositions[0], triangulatedWSPoint))
+                           intermediateCSPositions[0], _triangulators[0], triangulatedWSPoint))
             {
                 isVertex1Computed = true;
                 finalWSPoints.append(triangulatedWSPoint);
             }
             if(triangulate(view, _onPressIntersectedComponent.edge->vertex2,
-                           intermediateCSPositions[1], triangulatedWSPoint))
+                           intermediateCSPositions[1], _triangulators[1], triangulatedWSPoint))
             {
                 isVertex2Computed = true;
                 finalWSPoints.append(triangulatedWSPoint);
@@ -471,6 +480,7 @@ void MVGMoveManipulator::computeTriangulatedPoints(M3dView& view, MPointArray& f
 void MVGMoveManipulator::computePCPoints(M3dView& view, MPointArray& finalWSPoints)
 {
     finalWSPoints.clear();
+    const MVGGeometryUtil::ViewTransform transform(view);
     MVGMesh mesh(_onPressIntersectedComponent.meshPath);
     switch(_onPressIntersectedComponent.type)
     {
@@ -497,13 +507,14 @@ void MVGMoveManipulator::computePCPoints(M3dView& view, MPointArray& finalWSPoin
                 }
                 MPoint vertexWSPoint;
                 mesh.getPoint(verticesIDs[i], vertexWSPoint);
-                cameraSpacePoints.append(MVGGeometryUtil::worldToCameraSpace(view, vertexWSPoint));
+                cameraSpacePoints.append(
+                    MVGGeometryUtil::worldToCameraSpace(transform, vertexWSPoint));
             }
             assert(movingVertexIDInThisFace != -1);
             MPointArray worldSpacePoints;
             MVGPointCloud cloud(MVGProject::_CLOUD);
-            if(cloud.projectPoints(view, _visiblePointCloudItems, cameraSpacePoints,
-                                   worldSpacePoints))
+            if(cloud.projectPoints(view, _visiblePointCloudItems, _visiblePointCloudIndex,
+                                   cameraSpacePoints, worldSpacePoints, &_planeFitter))
             {
                 // add only the moved vertex position, not the other projected vertices
                 finalWSPoints.append(worldSpacePoints[movingVertexIDInThisFace]);
@@ -511,7 +522,8 @@ void MVGMoveManipulator::computePCPoints(M3dView& view, MPointArray& finalWSPoin
             else
             {
                 // Save positions for error display
-                _intermediateVSPoints = MVGGeometryUtil::cameraToViewSpace(view, cameraSpacePoints);
+                _intermediateVSPoints =
+                    MVGGeometryUtil::cameraToViewSpace(transform, cameraSpacePoints);
             }
             break;
         }
@@ -541,7 +553,8 @@ void MVGMoveManipulator::computePCPoints(M3dView& view, MPointArray& finalWSPoin
                 }
                 MPoint vertexWSPoint;
                 mesh.getPoint(verticesIDs[i], vertexWSPoint);
-                cameraSpacePoints.append(MVGGeometryUtil::worldToCameraSpace(view, vertexWSPoint));
+                cameraSpacePoints.append(
+                    MVGGeometryUtil::worldToCameraSpace(transform, vertexWSPoint));
             }
             // Project mouse on point cloud
             MPoint projectedMouseWS;
@@ -550,8 +563,10 @@ void MVGMoveManipulator::computePCPoints(M3dView& view, MPointArray& finalWSPoin
             constraintedWSPoints.append(_onPressIntersectedComponent.edge->vertex1->worldPosition);
             constraintedWSPoints.append(_onPressIntersectedComponent.edge->vertex2->worldPosition);
             if(cloud.projectPointsWithLineConstraint(view, _visiblePointCloudItems,
-                                                     cameraSpacePoints, constraintedWSPoints,
-                                                     getMousePosition(view), projectedMouseWS))
+                                                     _visiblePointCloudIndex, cameraSpacePoints,
+                                                     constraintedWSPoints,
+                                                     getMousePosition(view), projectedMouseWS,
+                                                     &_planeFitter))
             {
                 MPointArray translatedWSEdgePoints;
                 getTranslatedWSEdgePoints(view, _onPressIntersectedComponent.edge, _onPressCSPoint,
@@ -564,7 +579,8 @@ void MVGMoveManipulator::computePCPoints(M3dView& view, MPointArray& finalWSPoin
             {
                 // Save positions for error display
                 cameraSpacePoints.remove(cameraSpacePoints.length() - 1);
-                _intermediateVSPoints = MVGGeometryUtil::cameraToViewSpace(view, cameraSpacePoints);
+                _intermediateVSPoints =
+                    MVGGeometryUtil::cameraToViewSpace(transform, cameraSpacePoints);
             }
             break;
         }
@@ -728,18 +744,56 @@ MStatus MVGMoveManipulator::resetTweakInformation()
 
 bool MVGMoveManipulator::triangulate(M3dView& view, MVGManipulatorCache::VertexData* vertex,
                                      const MPoint& currentVertexPositionsInActiveView,
+                                     MVGPointTriangulator& triangulator,
                                      MPoint& triangulatedWSPoint)
 {
     // retrieve blind data
-    std::map<int, MPoint> blindData = vertex->blindData;
+    std::map<int, MPoint> blindData(vertex->blindData.begin(), vertex->blindData.end());
     // override blind data for the active camera
     blindData[_cache->getActiveCamera().getId()] = currentVertexPositionsInActiveView;
     if(blindData.size() < 2)
         return false;
-    MVGGeometryUtil::triangulatePoint(blindData, triangulatedWSPoint);
+    std::map<int, double> residualPerCamera;
+    if(!MVGGeometryUtil::triangulatePoint(blindData, triangulatedWSPoint, &triangulator,
+                                          &residualPerCamera))
+        return false;
+    for(std::map<int, double>::const_iterator it = residualPerCamera.begin();
+        it != residualPerCamera.end(); ++it)
+    {
+        TriangulationResidual residual;
+        residual.cameraId = it->first;
+        residual.cameraPoint = blindData[it->first];
+        residual.error = it->second;
+        _triangulationResiduals.push_back(residual);
+    }
     return true;
 }
 
+/**
+ * Draw the reprojection error of the triangulated points next to their 2D position in the view
+ * @param view
+ * @param camera
+ */
+void MVGMoveManipulator::drawTriangulationResiduals(M3dView& view, const MVGCamera& camera)
+{
+    if(!camera.isValid())
+        return;
+    const MVGGeometryUtil::ViewTransform transform(view);
+    const int cameraID = camera.getId();
+    view.setDrawColor(MVGDrawUtil::_triangulateColor);
+    for(std::vector<TriangulationResidual>::const_iterator it = _triangulationResiduals.begin();
+        it != _triangulationResiduals.end(); ++it)
+    {
+        if(it->cameraId != cameraID)
+            continue;
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << it->error << " px";
+        const MPoint pointVS = MVGGeometryUtil::cameraToViewSpace(transform, it->cameraPoint);
+        view.drawText(MString(text.str().c_str()),
+                      MVGGeometryUtil::viewToWorldSpace(view, pointVS + MPoint(10, -15)));
+    }
+}
+
 // static
 void MVGMoveManipulator::drawCursor(const MPoint& originVS)
 {
@@ -774,6 +828,7 @@ void MVGMoveManipulator::drawPlacedPoints(
 {
     if(!camera.isValid())
         return;
+    const MVGGeometryUtil::ViewTransform transform(view);
 
     // browse meshes
     const std::map<std::string, MVGManipulatorCache::MeshData>& meshData = cache->getMeshData();
@@ -786,7 +841,7 @@ void MVGMoveManipulator::drawPlacedPoints(
                 vertices.begin();
             verticesIt != vertices.end(); ++verticesIt)
         {
-            std::map<int, MPoint>::const_iterator currentData =
+            MVGManipulatorCache::BlindData::const_iterator currentData =
                 verticesIt->blindData.find(camera.getId());
             if(currentData == verticesIt->blindData.end())
                 continue;
@@ -812,10 +867,11 @@ void MVGMoveManipulator::drawPlacedPoints(
 
             // 2D position
             MPoint clickedVSPoint =
-                MVGGeometryUtil::cameraToViewSpace(view, verticesIt->blindData.at(camera.getId()));
+                MVGGeometryUtil::cameraToViewSpace(transform, currentData->second);
             MVGDrawUtil::drawFullCross(clickedVSPoint, 7, 1, MVGDrawUtil::_triangulateColor);
             // Link between 2D/3D positions
-            MPoint vertexVS = MVGGeometryUtil::worldToViewSpace(view, verticesIt->worldPosition);
+            MPoint vertexVS =
+                MVGGeometryUtil::worldToViewSpace(transform, verticesIt->worldPosition);
             MVGDrawUtil::drawLine2D(clickedVSPoint, vertexVS, MVGDrawUtil::_triangulateColor, 1.5f,
                                     1.f, true);
             // Number of placed points
@@ -843,7 +899,7 @@ void MVGMoveManipulator::drawComplementaryIntersectedBlindData(
     if(!camera.isValid())
         return;
 
-    const std::map<int, MPoint>::const_iterator it =
+    const MVGManipulatorCache::BlindData::const_iterator it =
         intersectedComponent.vertex->blindData.find(camera.getId());
     if(it != intersectedComponent.vertex->blindData.end())
     {
@@ -868,7 +924,7 @@ void MVGMoveManipulator::drawVertexOnHover(M3dView& view, MVGManipulatorCache* c
     if(!cache->getActiveCamera().isValid())
         return;
     const int cameraID = cache->getActiveCamera().getId();
-    std::map<int, MPoint> intersectedBD;
+    MVGManipulatorCache::BlindData intersectedBD;
     switch(intersectedComponent.type)
     {
         case MFn::kMeshVertComponent:
@@ -917,7 +973,7 @@ MVGMoveManipulator::drawSelectedPoint2D(M3dView& view, const MVGCamera& camera,
     if(selectedComponent.type != MFn::kMeshVertComponent &&
        selectedComponent.type != MFn::kBlindData)
         return;
-    std::map<int, MPoint>::const_iterator currentData =
+    MVGManipulatorCache::BlindData::const_iterator currentData =
         selectedComponent.vertex->blindData.find(camera.getId());
     if(currentData != selectedComponent.vertex->blindData.end())
     {
@@ -963,7 +1019,7 @@ MVGMoveManipulator::drawPointToBePlaced(M3dView& view, const MVGCamera& camera,
        selectedComponent.type != MFn::kBlindData)
         return;
 
-    std::map<int, MPoint>::const_iterator currentData =
+    MVGManipulatorCache::BlindData::const_iterator currentData =
         selectedComponent.vertex->blindData.find(camera.getId());
 
     // Only draw if no blind data for the current view
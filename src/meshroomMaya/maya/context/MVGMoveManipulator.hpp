@@ -1,6 +1,8 @@
 #pragma once
 
 #include "meshroomMaya/maya/context/MVGManipulator.hpp"
+#include "meshroomMaya/core/MVGIncrementalPlaneFitter.hpp"
+#include "meshroomMaya/core/MVGPointTriangulator.hpp"
 
 namespace meshroomMaya
 {
@@ -39,7 +41,9 @@ private:
     MStatus storeTweakInformation();
     MStatus resetTweakInformation();
     bool triangulate(M3dView& view, MVGManipulatorCache::VertexData* vertex,
-                     const MPoint& currentVertexPositionsInActiveView, MPoint& triangulatedWSPoint);
+                     const MPoint& currentVertexPositionsInActiveView,
+                     MVGPointTriangulator& triangulator, MPoint& triangulatedWSPoint);
+    void drawTriangulationResiduals(M3dView& view, const MVGCamera& camera);
 
 public:
     static void drawCursor(const MPoint& originVS);
@@ -64,11 +68,27 @@ public:
     static MString _drawDbClassification;
     static MString _drawRegistrantID;
     static EMoveMode _mode;
+    /// residual deviation allowed to the incremental plane of the moved face, relative to the
+    /// in-plane deviation of the enclosed points (see MVGIncrementalPlaneFitter)
+    static double _planeMaxResidualRatio;
 
 private:
     /// 2D view space points of the moved face.
     /// It's needed to draw face wireframe even if no plane is found.
     MPointArray _intermediateVSPoints;
+    /// plane of the points enclosed by the moved face, updated on each drag event
+    MVGIncrementalPlaneFitter _planeFitter;
+    /// triangulation of each moved point, starting from its previous position on drag events
+    MVGPointTriangulator _triangulators[2];
+    /// reprojection error of the triangulated points, in pixels
+    struct TriangulationResidual
+    {
+        int cameraId;
+        /// camera space position the error is measured from
+        MPoint cameraPoint;
+        double error;
+    };
+    std::vector<TriangulationResidual> _triangulationResiduals;
 };
 
 } // namespace
@@ -112,6 +112,22 @@ MStatus MVGMeshEditFactory::doIt()
                 CHECK(mesh.unsetBlindData(_componentIDs[i]));
             break;
         }
+        case kSetPoints:
+        {
+            // move many vertices at once, keeping their blind data
+            if(_componentIDs.length() != _worldPositions.length())
+                return MS::kFailure;
+            MPointArray points;
+            CHECK_RETURN_STATUS(mesh.getPoints(points))
+            for(size_t i = 0; i < _componentIDs.length(); ++i)
+            {
+                if(_componentIDs[i] < 0 || _componentIDs[i] >= (int)points.length())
+                    continue;
+                points[_componentIDs[i]] = _worldPositions[i];
+            }
+            CHECK_RETURN_STATUS(mesh.setAllPoints(points))
+            break;
+        }
     }
 
     return status;
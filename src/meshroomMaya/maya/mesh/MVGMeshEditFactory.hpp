@@ -19,6 +19,7 @@ public:
         kAddFace = 0,
         kMove = 1,
         kClearBD = 2,
+        kSetPoints = 3,
     };
 
 public:
@@ -92,6 +92,8 @@ MStatus MVGMeshEditNode::initialize()
     eAttr.setStorable(true);
     eAttr.addField("create", 0);
     eAttr.addField("move", 1);
+    eAttr.addField("clearBlindData", 2);
+    eAttr.addField("setPoints", 3);
     CHECK_RETURN_STATUS(addAttribute(aInEditType))
 
     aOutMesh = tAttr.create("outMesh", "om", MFnMeshData::kMesh, &status);
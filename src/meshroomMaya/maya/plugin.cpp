@@ -1,4 +1,6 @@
 #include "meshroomMaya/core/MVGLog.hpp"
+#include "meshroomMaya/core/MVGProjectionCache.hpp"
+#include "meshroomMaya/core/MVGProject.hpp"
 #include "meshroomMaya/version.hpp"
 #include "meshroomMaya/maya/MVGMayaUtil.hpp"
 #include "meshroomMaya/maya/MVGMayaCallbacks.hpp"
@@ -6,6 +8,7 @@
 #include "meshroomMaya/maya/cmd/MVGEditCmd.hpp"
 #include "meshroomMaya/maya/cmd/MVGImagePlaneCmd.hpp"
 #include "meshroomMaya/maya/cmd/MVGSelectClosestCamCmd.hpp"
+#include "meshroomMaya/maya/cmd/MVGRetriangulateCmd.hpp"
 #include "meshroomMaya/maya/context/MVGContextCmd.hpp"
 #include "meshroomMaya/maya/context/MVGCreateManipulator.hpp"
 #include "meshroomMaya/maya/context/MVGMoveManipulator.hpp"
@@ -140,6 +143,8 @@ MStatus initializePlugin(MObject obj)
     CHECK(plugin.registerCommand("MVGImagePlaneCmd", MVGImagePlaneCmd::creator,
                                  MVGImagePlaneCmd::newSyntax))
     CHECK(plugin.registerCommand(MVGSelectClosestCamCmd::_name, MVGSelectClosestCamCmd::creator))
+    CHECK(plugin.registerCommand(MVGRetriangulateCmd::_name, MVGRetriangulateCmd::creator,
+                                 MVGRetriangulateCmd::newSyntax))
     CHECK(plugin.registerContextCommand(MVGContextCmd::name, &MVGContextCmd::creator,
                                         MVGEditCmd::_name, MVGEditCmd::creator,
                                         MVGEditCmd::newSyntax))
@@ -174,6 +179,9 @@ MStatus initializePlugin(MObject obj)
         MVGCameraPointsLocator::classification, MVGCameraPointsLocator::registrantId,
         MVGCameraPointsDrawOverride::creator)) 
 
+    // Image cache budget from the environment
+    MVGProject::initImageCacheBudget();
+
     // Register Maya callbacks
     MCallbackId id;
     if(!MUserEventMessage::isUserEvent(_modeChangedEvent))
@@ -200,6 +208,14 @@ MStatus initializePlugin(MObject obj)
     if(status)
         _callbacks.append(id);
     id = MEventMessage::addEventCallback("quitApplication", quitApplicationCB, &status);
+    if(status)
+        _callbacks.append(id);
+    id = MSceneMessage::addCallback(MSceneMessage::kBeforeSave, saveImageMetadataCB, NULL,
+                                    &status);
+    if(status)
+        _callbacks.append(id);
+    id = MSceneMessage::addCallback(MSceneMessage::kMayaExiting, saveImageMetadataCB, NULL,
+                                    &status);
     if(status)
         _callbacks.append(id);
     id = MEventMessage::addEventCallback("SelectionChanged", selectionChangedCB, &status);
@@ -215,6 +231,9 @@ MStatus initializePlugin(MObject obj)
     if(status)
         _callbacks.append(id);
     id = MDGMessage::addNodeRemovedCallback(nodeRemovedCB, "mesh", &status);
+    if(status)
+        _callbacks.append(id);
+    id = MDGMessage::addNodeRemovedCallback(nodeRemovedCB, "camera", &status);
     if(status)
         _callbacks.append(id);
     id = MDGMessage::addNodeAddedCallback(nodeAddedCB, "objectSet", &status);
@@ -239,6 +258,9 @@ MStatus uninitializePlugin(MObject obj)
     // Delete hotkeys
     deregisterMVGHotkeys();
 
+    // Keep image metadata probed since the project was loaded
+    MVGImageMetadataIndex::save();
+
     // Delete custom GUI
     CHECK(MVGMayaUtil::deleteMVGContext())
     CHECK(MVGMayaUtil::deleteMVGWindow())
@@ -246,11 +268,13 @@ MStatus uninitializePlugin(MObject obj)
     // Deregister Maya callbacks
     CHECK(MUserEventMessage::deregisterUserEvent(_modeChangedEvent))
     CHECK(MMessage::removeCallbacks(_callbacks))
+    MVGProjectionCache::clear();
 
     // Deregister Maya context, commands & nodes
     CHECK(plugin.deregisterCommand("MVGCmd"))
     CHECK(plugin.deregisterCommand("MVGSelectClosestCamCmd"))
     CHECK(plugin.deregisterCommand("MVGImagePlaneCmd"))
+    CHECK(plugin.deregisterCommand(MVGRetriangulateCmd::_name))
     CHECK(plugin.deregisterContextCommand(MVGContextCmd::name, MVGEditCmd::_name))
     CHECK(plugin.deregisterNode(MVGCreateManipulator::_id))
     CHECK(plugin.deregisterNode(MVGMoveManipulator::_id))
@@ -0,0 +1,79 @@
+#include "meshroomMaya/qt/MVGCameraListModel.hpp"
+#include "meshroomMaya/qt/MVGCameraRecords.hpp"
+#include "meshroomMaya/qt/MVGCameraWrapper.hpp"
+#include <algorithm>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+/// over this ratio of moved rows, setCameras resets the model instead
+static const double MAX_MOVED_ROWS_RATIO = 0.25;
+
+} // empty namespace
+
+MVGCameraListModel::MVGCameraListModel(MVGCameraRecords& records, QObject* parent)
+    : QAbstractListModel(parent)
+    , _records(records)
+{
+}
+
+QHash<int, QByteArray> MVGCameraListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[ObjectRole] = "object";
+    return roles;
+}
+
+int MVGCameraListModel::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return count();
+}
+
+QVariant MVGCameraListModel::data(const QModelIndex& index, int role) const
+{
+    if(index.row() < 0 || index.row() >= _cameras.size() || role != ObjectRole)
+        return QVariant();
+    QObject* wrapper = _records.getWrapper(_cameras.at(index.row()));
+    return QVariant::fromValue(wrapper);
+}
+
+void MVGCameraListModel::setCameras(const QList<int>& cameras)
+{
+    const int oldCount = _cameras.count();
+    if(!patchRows(*this, _cameras, cameras, MAX_MOVED_ROWS_RATIO))
+    {
+        beginResetModel();
+        _cameras = cameras;
+        endResetModel();
+    }
+    if(_cameras.count() != oldCount)
+        Q_EMIT countChanged();
+}
+
+QObject* MVGCameraListModel::get(int i) const
+{
+    if(i < 0 || i >= _cameras.size())
+        return nullptr;
+    return _records.getWrapper(_cameras.at(i));
+}
+
+QStringList MVGCameraListModel::getDagPaths(int first, int last) const
+{
+    QStringList dagPaths;
+    first = std::max(first, 0);
+    last = std::min(last, _cameras.size() - 1);
+    for(int i = first; i <= last; ++i)
+    {
+        const int camera = _cameras.at(i);
+        if(!_records.isValid(camera))
+            continue;
+        dagPaths.append(QString::fromStdString(_records.getCamera(camera).getDagPathAsString()));
+    }
+    return dagPaths;
+}
+
+} // namespace
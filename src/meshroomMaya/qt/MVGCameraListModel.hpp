@@ -0,0 +1,65 @@
+#pragma once
+
+#include "meshroomMaya/qt/MVGListModelPatch.hpp"
+#include <QAbstractListModel>
+#include <QStringList>
+
+namespace meshroomMaya
+{
+
+class MVGCameraRecords;
+
+/**
+ * MVGCameraListModel exposes a list of cameras to QML views, with the same API as
+ * QObjectListModel: an \c object role, a \c count property and a \c get(int i) function.
+ * Rows are camera indexes in MVGCameraRecords, their wrapper is only created when requested.
+ */
+class MVGCameraListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles
+    {
+        ObjectRole = Qt::UserRole + 1
+    };
+
+public:
+    MVGCameraListModel(MVGCameraRecords& records, QObject* parent = nullptr);
+
+    QHash<int, QByteArray> roleNames() const override;
+    int rowCount(const QModelIndex& parent) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+
+    MVGCameraRecords& getRecords() const { return _records; }
+    const QList<int>& getCameras() const { return _cameras; }
+    /// Sets the cameras of the model, only notifying views of the rows that changed
+    void setCameras(const QList<int>& cameras);
+    inline int at(int i) const { return _cameras.at(i); }
+    inline int indexOf(int camera) const { return _cameras.indexOf(camera); }
+    inline int count() const { return _cameras.count(); }
+
+    // additional QML API
+    Q_INVOKABLE QObject* get(int i) const;
+    /// Dag paths of the cameras from row first to row last included
+    Q_INVOKABLE QStringList getDagPaths(int first, int last) const;
+
+Q_SIGNALS:
+    void countChanged();
+
+private:
+    template <typename Model, typename T>
+    friend bool patchRows(Model& model, QList<T>& rows, const QList<T>& target,
+                          const double maxMovedRatio);
+
+    void referenceItem(int) {}
+    void dereferenceItem(int) {}
+
+private:
+    Q_DISABLE_COPY(MVGCameraListModel)
+    MVGCameraRecords& _records;
+    QList<int> _cameras;
+};
+
+} // namespace
@@ -0,0 +1,122 @@
+#include "meshroomMaya/qt/MVGCameraRecords.hpp"
+#include "meshroomMaya/qt/MVGCameraWrapper.hpp"
+#include <QQmlEngine>
+
+namespace meshroomMaya
+{
+
+// static
+const size_t MVGCameraRecords::MAX_LIVE_WRAPPERS = 256;
+
+MVGCameraRecords::Record::Record(const MVGCamera& camera)
+    : camera(camera)
+    , imagePathLoaded(false)
+    , isSelected(false)
+    , isRemoved(false)
+    , wrapper(nullptr)
+{
+}
+
+MVGCameraRecords::MVGCameraRecords()
+{
+}
+
+MVGCameraRecords::~MVGCameraRecords()
+{
+    clear();
+}
+
+void MVGCameraRecords::reset(const std::vector<MVGCamera>& cameras)
+{
+    clear();
+    _records.reserve(cameras.size());
+    for(const MVGCamera& camera : cameras)
+        _records.push_back(Record(camera));
+}
+
+void MVGCameraRecords::clear()
+{
+    // Wrappers pending deletion must not read the records anymore
+    for(const int index : _recentWrappers)
+    {
+        _records[index].wrapper->_records = nullptr;
+        _records[index].wrapper->deleteLater();
+    }
+    _recentWrappers.clear();
+    _records.clear();
+}
+
+const QString& MVGCameraRecords::getImagePath(const int index)
+{
+    Record& record = _records[index];
+    if(!record.imagePathLoaded)
+    {
+        record.imagePath = QString::fromStdString(record.camera.getThumbnailPath());
+        record.imagePathLoaded = true;
+    }
+    return record.imagePath;
+}
+
+void MVGCameraRecords::setSelected(const int index, const bool isSelected)
+{
+    Record& record = _records[index];
+    if(record.isSelected == isSelected)
+        return;
+    record.isSelected = isSelected;
+    if(record.wrapper)
+        Q_EMIT record.wrapper->isSelectedChanged();
+}
+
+void MVGCameraRecords::setInView(const int index, const QString& viewName, const bool value)
+{
+    Record& record = _records[index];
+    if(value)
+    {
+        if(!record.views.contains(viewName))
+        {
+            record.views.push_back(viewName);
+            if(record.wrapper)
+                Q_EMIT record.wrapper->viewsChanged();
+        }
+        record.camera.setInView(viewName.toStdString());
+    }
+    else
+    {
+        if(record.views.removeOne(viewName) && record.wrapper)
+            Q_EMIT record.wrapper->viewsChanged();
+    }
+}
+
+MVGCameraWrapper* MVGCameraRecords::getWrapper(const int index)
+{
+    if(!isValid(index))
+        return nullptr;
+    Record& record = _records[index];
+    if(record.wrapper)
+    {
+        _recentWrappers.splice(_recentWrappers.begin(), _recentWrappers, record.recentIt);
+        return record.wrapper;
+    }
+    record.wrapper = new MVGCameraWrapper(*this, index);
+    // Explicitly keep the ownership on C++ side which is not the default behavior
+    // for INVOKABLE methods (i.e MVGCameraListModel::get) if object has no parent.
+    QQmlEngine::setObjectOwnership(record.wrapper, QQmlEngine::CppOwnership);
+    _recentWrappers.push_front(index);
+    record.recentIt = _recentWrappers.begin();
+    if(_recentWrappers.size() > MAX_LIVE_WRAPPERS)
+        releaseWrapper(_recentWrappers.back());
+    return record.wrapper;
+}
+
+void MVGCameraRecords::releaseWrapper(const int index)
+{
+    Record& record = _records[index];
+    if(!record.wrapper)
+        return;
+    _recentWrappers.erase(record.recentIt);
+    // Deleted once back to the event loop, the caller may still be using it
+    record.wrapper->deleteLater();
+    record.wrapper = nullptr;
+}
+
+} // namespace
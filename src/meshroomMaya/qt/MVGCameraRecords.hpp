@@ -0,0 +1,79 @@
+#pragma once
+
+#include "meshroomMaya/core/MVGCamera.hpp"
+#include <QString>
+#include <QStringList>
+#include <list>
+#include <vector>
+
+namespace meshroomMaya
+{
+
+class MVGCameraWrapper;
+
+/**
+ * @brief Cameras of the project, stored as light records referenced by index from the camera
+ * set models and the project indexes.
+ *
+ * The QObject wrappers used by QML are only created for the rows QML requests, and only the
+ * MAX_LIVE_WRAPPERS most recently requested ones are kept alive. Wrappers are views on the
+ * records: the selection and views state of a camera survives the deletion of its wrapper.
+ */
+class MVGCameraRecords
+{
+public:
+    MVGCameraRecords();
+    ~MVGCameraRecords();
+
+public:
+    /// Replace the records by one per camera, in the same order
+    void reset(const std::vector<MVGCamera>& cameras);
+    void clear();
+    int size() const { return static_cast<int>(_records.size()); }
+    bool isValid(const int index) const { return index >= 0 && index < size(); }
+
+    const MVGCamera& getCamera(const int index) const { return _records[index].camera; }
+    const QString& getImagePath(const int index);
+    bool isSelected(const int index) const { return _records[index].isSelected; }
+    void setSelected(const int index, const bool isSelected);
+    const QStringList& getViews(const int index) const { return _records[index].views; }
+    void setInView(const int index, const QString& viewName, const bool value);
+    /// Removed cameras keep their index until the next reset
+    bool isRemoved(const int index) const { return _records[index].isRemoved; }
+    void setRemoved(const int index) { _records[index].isRemoved = true; }
+
+    /**
+     * @brief Get the wrapper of a camera, creating it if needed.
+     * The least recently requested wrapper is deleted when more than MAX_LIVE_WRAPPERS are
+     * alive: wrappers must not be stored on the C++ side.
+     * @return the wrapper, or nullptr if index is not a valid camera
+     */
+    MVGCameraWrapper* getWrapper(const int index);
+    /// Delete the wrapper of a camera, if any
+    void releaseWrapper(const int index);
+
+private:
+    struct Record
+    {
+        explicit Record(const MVGCamera& camera);
+
+        MVGCamera camera;
+        /// the thumbnail path is read on first access
+        QString imagePath;
+        bool imagePathLoaded;
+        bool isSelected;
+        bool isRemoved;
+        QStringList views; //< camera is displayed in thoses views
+        MVGCameraWrapper* wrapper; //< live wrapper, or nullptr
+        std::list<int>::iterator recentIt; //< position of the live wrapper in _recentWrappers
+    };
+
+    /// well above the number of delegates a camera list view instantiates
+    static const size_t MAX_LIVE_WRAPPERS;
+
+    std::vector<Record> _records;
+    /// indexes of the cameras with a live wrapper, most recently requested first
+    std::list<int> _recentWrappers;
+};
+
+} // namespace
@@ -1,5 +1,5 @@
 #include "MVGCameraSetWrapper.hpp"
-#include "MVGCameraWrapper.hpp"
+#include "MVGCameraRecords.hpp"
 #include "meshroomMaya/core/MVGProject.hpp"
 
 #include <maya/MItDependencyNodes.h>
@@ -9,16 +9,18 @@ namespace meshroomMaya
 
 const MColor MVGCameraSetWrapper::LOCATOR_HIGHLIGHT_COLOR = MColor(0.37f, 0.91f, 0.65f, 1.0f);
     
-MVGCameraSetWrapper::MVGCameraSetWrapper(const QString& displayName, QObject* parent):
+MVGCameraSetWrapper::MVGCameraSetWrapper(MVGCameraRecords& records, const QString& displayName,
+                                         QObject* parent):
 QObject(parent),
 _displayName(displayName),
-_cameraWrappers(this)
+_cameras(records, this)
 {
 }
 
-MVGCameraSetWrapper::MVGCameraSetWrapper(const MObject& set, QObject* parent):
+MVGCameraSetWrapper::MVGCameraSetWrapper(MVGCameraRecords& records, const MObject& set,
+                                         QObject* parent):
 QObject(parent),
-_cameraWrappers(this)
+_cameras(records, this)
 {
     _fnSet.setObject(set);
     std::string shortName = _fnSet.name().asChar();
@@ -29,10 +31,10 @@ _cameraWrappers(this)
 MVGCameraSetWrapper::MVGCameraSetWrapper(const MVGCameraSetWrapper& other):
 QObject(other.parent()),
 _displayName(other._displayName),
-_cameraWrappers(this)
+_cameras(other._cameras.getRecords(), this)
 {
     _fnSet.setObject(other.fnSet().object());
-    _cameraWrappers.setObjectList(other._cameraWrappers.objectList());
+    _cameras.setCameras(other._cameras.getCameras());
 }
 
 MVGCameraSetWrapper::~MVGCameraSetWrapper()
@@ -41,11 +43,13 @@ MVGCameraSetWrapper::~MVGCameraSetWrapper()
 
 void MVGCameraSetWrapper::highlightLocators(bool highlight)
 {
-    for(auto* cam : _cameraWrappers.asQList<MVGCameraWrapper>())
+    const MVGCameraRecords& records = _cameras.getRecords();
+    for(const int cam : _cameras.getCameras())
     {
-        if(!cam->getViews().empty())
+        if(!records.isValid(cam) || records.isRemoved(cam) || !records.getViews(cam).empty())
             continue;  // Already defines a custom locator color matching the panel's color
-        cam->getCamera().setLocatorCustomColor(highlight, highlight ? LOCATOR_HIGHLIGHT_COLOR : MColor());
+        records.getCamera(cam).setLocatorCustomColor(highlight,
+                                                     highlight ? LOCATOR_HIGHLIGHT_COLOR : MColor());
     }
 }
 
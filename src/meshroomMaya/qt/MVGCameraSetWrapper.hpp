@@ -1,7 +1,7 @@
 #pragma once
 
 #include "MVGQt.hpp"
-#include "QObjectListModel.hpp"
+#include "MVGCameraListModel.hpp"
 #include <maya/MColor.h>
 #include <maya/MFnSet.h>
 
@@ -17,24 +17,26 @@ class MVGCameraSetWrapper : public QObject
     Q_OBJECT
 
     Q_PROPERTY(QString name READ getDisplayName NOTIFY nameChanged)
-    Q_PROPERTY(QObjectListModel* cameras READ getCameras CONSTANT)
+    Q_PROPERTY(meshroomMaya::MVGCameraListModel* cameras READ getCameras CONSTANT)
     Q_PROPERTY(bool editable READ isEditable CONSTANT)
 
 public:
-    MVGCameraSetWrapper(const QString& displayName="-", QObject* parent=nullptr);
-    MVGCameraSetWrapper(const MObject& set, QObject* parent=nullptr);
+    MVGCameraSetWrapper(MVGCameraRecords& records, const QString& displayName="-",
+                        QObject* parent=nullptr);
+    MVGCameraSetWrapper(MVGCameraRecords& records, const MObject& set, QObject* parent=nullptr);
     MVGCameraSetWrapper(const MVGCameraSetWrapper& other);
     virtual ~MVGCameraSetWrapper();
 
     const MFnSet& fnSet() const { return _fnSet; }
     
     QString getDisplayName() { return _displayName; }
-    QObjectListModel* getCameras() { return &_cameraWrappers; }
+    MVGCameraListModel* getCameras() { return &_cameras; }
     
-    /// Sets the camera wrappers corresponding to this camera set
-    void setCameraWrappers(const QObjectList& camWrappers)
+    /// Sets the indexes of the cameras corresponding to this camera set,
+    /// only notifying views of the rows that changed
+    void setCameras(const QList<int>& cameras)
     {
-        _cameraWrappers.setObjectList(camWrappers);
+        _cameras.setCameras(cameras);
     }
 
     void highlightLocators(bool highlight=true);
@@ -52,7 +54,7 @@ private:
 
     MFnSet _fnSet;
     QString _displayName;
-    QObjectListModel _cameraWrappers;
+    MVGCameraListModel _cameras;
 };
 
 }
@@ -1,89 +1,83 @@
 #include "meshroomMaya/qt/MVGCameraWrapper.hpp"
-#include <QImage>
-#include <QFileInfo>
+#include "meshroomMaya/qt/MVGImageMetadataIndex.hpp"
 
 namespace meshroomMaya
 {
 
-MVGCameraWrapper::MVGCameraWrapper(const MVGCamera& camera, QObject* parent)
-    : QObject(parent)
-    , _camera(camera)
-    , _isSelected(false)
-    , _imageLoaded(false)
+MVGCameraWrapper::MVGCameraWrapper(MVGCameraRecords& records, const int index)
+    : _records(&records)
+    , _index(index)
 {
 }
 
-MVGCameraWrapper::MVGCameraWrapper(const MVGCameraWrapper& other)
-    : QObject(other.parent())
-    , _camera(other._camera)
-    , _imageLoaded(other._imageLoaded)
-    , _imageSize(other._imageSize)
-    , _isSelected(other._isSelected)
-    , _views(other._views)
+MVGCameraWrapper::~MVGCameraWrapper()
 {
 }
 
-MVGCameraWrapper::~MVGCameraWrapper()
+const QString MVGCameraWrapper::getName() const
 {
+    if(!_records)
+        return QString();
+    return QString::fromStdString(_records->getCamera(_index).getName());
 }
 
-const MVGCamera& MVGCameraWrapper::getCamera() const
+const QString MVGCameraWrapper::getDagPathAsString() const
 {
-    return _camera;
+    if(!_records)
+        return QString();
+    return QString::fromStdString(_records->getCamera(_index).getDagPathAsString());
 }
 
-void MVGCameraWrapper::setInView(const QString& viewName, const bool value)
+const QString MVGCameraWrapper::getImagePath()
 {
-    if(value)
-    {
-        if(!_views.contains(viewName))
-        {
-            _views.push_back(viewName);
-            Q_EMIT viewsChanged();
-        }
-        _camera.setInView(viewName.toStdString());
-    }
-    else
-    {
-        if(_views.removeOne(viewName))
-            Q_EMIT viewsChanged();
-    }
+    if(!_records)
+        return QString();
+    return _records->getImagePath(_index);
 }
 
-const QString MVGCameraWrapper::getDagPathAsString() const
+bool MVGCameraWrapper::isSelected() const
 {
-    return QString::fromStdString(_camera.getDagPathAsString());
+    return _records && _records->isSelected(_index);
 }
 
 void MVGCameraWrapper::setIsSelected(const bool isSelected)
 {
-    if(_isSelected == isSelected)
-        return;
-    _isSelected = isSelected;
-    Q_EMIT isSelectedChanged();
+    if(_records)
+        _records->setSelected(_index, isSelected);
+}
+
+const QStringList MVGCameraWrapper::getViews() const
+{
+    if(!_records)
+        return QStringList();
+    return _records->getViews(_index);
+}
+
+bool MVGCameraWrapper::isInView(const QString& viewName) const
+{
+    return _records && _records->getViews(_index).contains(viewName);
+}
+
+void MVGCameraWrapper::setInView(const QString& viewName, const bool value)
+{
+    if(_records)
+        _records->setInView(_index, viewName, value);
 }
 
 const QSize MVGCameraWrapper::getSourceSize()
 {
-    // TODO : do not load image
-    if(!_imageLoaded)
-    {
-        QImage image(getImagePath());
-        _imageLoaded = true;
-        _imageSize = image.size();
-    }
-    return _imageSize;
+    return MVGImageMetadataIndex::get(getImagePath()).size;
 }
 
-const qint64 MVGCameraWrapper::getSourceWeight() const
+const qint64 MVGCameraWrapper::getSourceWeight()
 {
-    QFileInfo info(getImagePath());
-    return info.size();
+    return MVGImageMetadataIndex::get(getImagePath()).byteSize;
 }
 
 void MVGCameraWrapper::selectCameraNode() const
 {
-    _camera.selectNode();
+    if(_records)
+        _records->getCamera(_index).selectNode();
 }
 
 } // namespace
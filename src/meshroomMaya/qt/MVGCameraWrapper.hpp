@@ -1,6 +1,6 @@
 #pragma once
 
-#include "meshroomMaya/core/MVGCamera.hpp"
+#include "meshroomMaya/qt/MVGCameraRecords.hpp"
 #include <QObject>
 #include <QSize>
 #include <QStringList>
@@ -8,6 +8,10 @@
 namespace meshroomMaya
 {
 
+/**
+ * MVGCameraWrapper exposes a camera record to QML.
+ * Wrappers are created on demand by MVGCameraRecords, see MVGCameraRecords::getWrapper.
+ */
 class MVGCameraWrapper : public QObject
 {
     Q_OBJECT
@@ -21,39 +25,36 @@ class MVGCameraWrapper : public QObject
     Q_PROPERTY(qint64 sourceWeight READ getSourceWeight CONSTANT)
 
 public:
-    MVGCameraWrapper(const MVGCamera& camera, QObject* parent=nullptr);
-    MVGCameraWrapper(const MVGCameraWrapper& other);
+    MVGCameraWrapper(MVGCameraRecords& records, const int index);
     ~MVGCameraWrapper();
 
 public Q_SLOTS:
-    const QString getName() const { return QString::fromStdString(_camera.getName()); }
+    const QString getName() const;
     const QString getDagPathAsString() const;
-    const QString getImagePath() const
-    {
-        return QString::fromStdString(_camera.getThumbnailPath());
-    }
-    bool isSelected() const { return _isSelected; }
+    const QString getImagePath();
+    bool isSelected() const;
     void setIsSelected(const bool isSelected);
-    const QStringList& getViews() const { return _views; }
+    const QStringList getViews() const;
     const QSize getSourceSize();
-    const qint64 getSourceWeight() const;
+    const qint64 getSourceWeight();
 
 Q_SIGNALS:
     void isSelectedChanged();
     void viewsChanged();
 
 public:
-    const MVGCamera& getCamera() const;
-    Q_INVOKABLE bool isInView(const QString& viewName) const { return _views.contains(viewName); }
+    /// Index of the camera in its records, -1 once the records are cleared
+    int getCameraIndex() const { return _records ? _index : -1; }
+    Q_INVOKABLE bool isInView(const QString& viewName) const;
     Q_INVOKABLE void setInView(const QString& viewName, const bool value);
     Q_INVOKABLE void selectCameraNode() const;
 
 private:
-    const MVGCamera _camera;
-    bool _imageLoaded;
-    QSize _imageSize;
-    bool _isSelected;
-    QStringList _views; //< camera is displayed in thoses views
+    friend class MVGCameraRecords;
+
+    /// null once the records are cleared, while the wrapper waits for its deletion
+    MVGCameraRecords* _records;
+    const int _index;
 };
 
 } // namespace
@@ -0,0 +1,144 @@
+#include "meshroomMaya/qt/MVGImageMetadataIndex.hpp"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QStandardPaths>
+
+namespace meshroomMaya
+{
+
+namespace
+{ // empty namespace
+
+static const quint32 INDEX_MAGIC = 0x4d56474d; // "MVGM"
+static const quint32 INDEX_VERSION = 1;
+
+} // empty namespace
+
+QString MVGImageMetadataIndex::_indexPath;
+QHash<QString, MVGImageMetadataIndex::Metadata> MVGImageMetadataIndex::_metadata;
+bool MVGImageMetadataIndex::_modified = false;
+
+/**
+ * @param projectPath path of the project (abc file)
+ * @return path of the index file of this project, in the user cache directory
+ */
+// static
+QString MVGImageMetadataIndex::getIndexPath(const QString& projectPath)
+{
+    if(projectPath.isEmpty())
+        return QString();
+    const QString cacheDirectory =
+        QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    const QByteArray hash =
+        QCryptographicHash::hash(projectPath.toUtf8(), QCryptographicHash::Md5).toHex();
+    return QDir(cacheDirectory).filePath("meshroomMaya/" + QString(hash) + ".mvgimages");
+}
+
+/**
+ * Save the current index if needed, then load the given one.
+ * @param indexPath path of the index file, may not exist yet
+ * @return whether the file has been read
+ */
+// static
+bool MVGImageMetadataIndex::load(const QString& indexPath)
+{
+    if(indexPath == _indexPath)
+        return true;
+    save();
+    clear();
+    _indexPath = indexPath;
+
+    QFile file(_indexPath);
+    if(_indexPath.isEmpty() || !file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if(magic != INDEX_MAGIC || version != INDEX_VERSION)
+        return false;
+    _metadata.reserve(count);
+    for(quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        QString imagePath;
+        Metadata metadata;
+        stream >> imagePath >> metadata.size >> metadata.byteSize >> metadata.lastModified;
+        _metadata.insert(imagePath, metadata);
+    }
+    if(stream.status() == QDataStream::Ok)
+        return true;
+    _metadata.clear();
+    return false;
+}
+
+/**
+ * Write the index file if new entries have been probed since the last load or save.
+ */
+// static
+bool MVGImageMetadataIndex::save()
+{
+    if(!_modified || _indexPath.isEmpty())
+        return true;
+    QDir().mkpath(QFileInfo(_indexPath).absolutePath());
+    QFile file(_indexPath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QDataStream stream(&file);
+    stream << INDEX_MAGIC << INDEX_VERSION << quint32(_metadata.size());
+    for(QHash<QString, Metadata>::const_iterator it = _metadata.constBegin();
+        it != _metadata.constEnd(); ++it)
+        stream << it.key() << it->size << it->byteSize << it->lastModified;
+    _modified = false;
+    return stream.status() == QDataStream::Ok;
+}
+
+// static
+void MVGImageMetadataIndex::clear()
+{
+    _indexPath.clear();
+    _metadata.clear();
+    _modified = false;
+}
+
+/**
+ * @param imagePath path of the image
+ * @return metadata of the image, read from the image header if not indexed or out of date
+ */
+// static
+const MVGImageMetadataIndex::Metadata& MVGImageMetadataIndex::get(const QString& imagePath)
+{
+    const QFileInfo info(imagePath);
+    const qint64 lastModified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+    QHash<QString, Metadata>::iterator it = _metadata.find(imagePath);
+    if(it != _metadata.end() && it->lastModified == lastModified && it->byteSize == info.size())
+        return *it;
+
+    Metadata metadata;
+    metadata.lastModified = lastModified;
+    metadata.byteSize = info.size();
+    if(info.exists())
+        probe(imagePath, metadata);
+    _modified = true;
+    return *_metadata.insert(imagePath, metadata);
+}
+
+/**
+ * Read image dimensions from the file header, and only decode the image if the format
+ * does not provide them.
+ */
+// static
+bool MVGImageMetadataIndex::probe(const QString& imagePath, Metadata& metadata)
+{
+    QImageReader reader(imagePath);
+    metadata.size = reader.size();
+    if(!metadata.size.isValid())
+        metadata.size = reader.read().size();
+    return metadata.size.isValid();
+}
+
+} // namespace
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QHash>
+#include <QSize>
+#include <QString>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Per project index of the source images dimensions and file sizes.
+ *
+ * Dimensions are read from the image headers (QImageReader::size) and never require to decode
+ * the image. The index is persisted in the user cache directory, one file per project, so that
+ * later sessions only have to compare file modification dates. Entries are refreshed when the
+ * image file changed on disk.
+ */
+class MVGImageMetadataIndex
+{
+
+public:
+    struct Metadata
+    {
+        Metadata()
+            : byteSize(0)
+            , lastModified(0)
+        {
+        }
+        QSize size;
+        qint64 byteSize;
+        qint64 lastModified; // msecs since epoch
+    };
+
+public:
+    static QString getIndexPath(const QString& projectPath);
+    static bool load(const QString& indexPath);
+    static bool save();
+    static void clear();
+
+public:
+    static const Metadata& get(const QString& imagePath);
+
+private:
+    static bool probe(const QString& imagePath, Metadata& metadata);
+
+private:
+    static QString _indexPath;
+    static QHash<QString, Metadata> _metadata;
+    static bool _modified;
+};
+
+} // namespace
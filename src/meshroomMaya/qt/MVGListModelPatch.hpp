@@ -0,0 +1,160 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QModelIndex>
+#include <QSet>
+#include <QVector>
+
+namespace meshroomMaya
+{
+
+/**
+ * @brief Update the rows of a list model to the target list with the minimal set of row
+ * removals, insertions and moves, so that attached views keep their delegates (and scrolling
+ * position) for the items that remain.
+ *
+ * Kept items following the same relative order as before (longest increasing subsequence) are
+ * not moved. Model must grant access to its row signals and provide referenceItem(T) and
+ * dereferenceItem(T), called on inserted and removed items.
+ * @param[in] model model whose rows are stored in rows
+ * @param[in,out] rows items of the model
+ * @param[in] target new items of the model
+ * @param[in] maxMovedRatio ratio of the target rows over which moving rows costs more than a
+ * reset
+ * @return false, leaving the model untouched, if target contains duplicates or if too many rows
+ * would have to move: the caller should reset the model instead
+ */
+template <typename Model, typename T>
+bool patchRows(Model& model, QList<T>& rows, const QList<T>& target, const double maxMovedRatio)
+{
+    QHash<T, int> targetIndexes;
+    targetIndexes.reserve(target.count());
+    for(int i = 0; i < target.count(); ++i)
+    {
+        if(targetIndexes.contains(target.at(i)))
+            return false;
+        targetIndexes.insert(target.at(i), i);
+    }
+
+    // Kept items that don't need to move: longest subsequence of the kept items that is
+    // increasing in the new list order
+    QVector<T> kept;
+    kept.reserve(rows.count());
+    for(const T& item : rows)
+    {
+        if(targetIndexes.contains(item))
+            kept.append(item);
+    }
+    QVector<int> tails; // index in kept of the last element of each subsequence length
+    QVector<int> predecessors(kept.count(), -1);
+    for(int i = 0; i < kept.count(); ++i)
+    {
+        const int targetIndex = targetIndexes.value(kept.at(i));
+        int low = 0, high = tails.count();
+        while(low < high)
+        {
+            const int mid = (low + high) / 2;
+            if(targetIndexes.value(kept.at(tails.at(mid))) < targetIndex)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if(low > 0)
+            predecessors[i] = tails.at(low - 1);
+        if(low == tails.count())
+            tails.append(i);
+        else
+            tails[low] = i;
+    }
+    QSet<T> stable;
+    for(int i = tails.isEmpty() ? -1 : tails.last(); i >= 0; i = predecessors.at(i))
+        stable.insert(kept.at(i));
+
+    if(kept.count() - stable.count() > maxMovedRatio * target.count())
+        return false;
+
+    // Remove items absent from the new list, by contiguous runs
+    for(int last = rows.count() - 1; last >= 0;)
+    {
+        if(targetIndexes.contains(rows.at(last)))
+        {
+            --last;
+            continue;
+        }
+        int first = last;
+        while(first > 0 && !targetIndexes.contains(rows.at(first - 1)))
+            --first;
+        model.beginRemoveRows(QModelIndex(), first, last);
+        for(int j = first; j <= last; ++j)
+            model.dereferenceItem(rows.takeAt(first));
+        model.endRemoveRows();
+        last = first - 1;
+    }
+
+    // Current row of the items not placed yet. Rows before the anchor are updated on each
+    // move; items left after the anchor (when the anchor jumps to a stable item) are tracked
+    // apart, as insertions and moves at the anchor shift them.
+    QHash<T, int> positions;
+    positions.reserve(rows.count());
+    for(int i = 0; i < rows.count(); ++i)
+        positions.insert(rows.at(i), i);
+    QVector<T> skipped;
+
+    // Walk the new list backwards, placing each item right before its successor
+    int anchor = rows.count();
+    for(int i = target.count() - 1; i >= 0;)
+    {
+        const T& item = target.at(i);
+        const int position = positions.value(item, -1);
+        if(position < 0)
+        {
+            // Insert contiguous new items at once
+            int first = i;
+            while(first > 0 && !positions.contains(target.at(first - 1)))
+                --first;
+            model.beginInsertRows(QModelIndex(), anchor, anchor + i - first);
+            for(int j = i; j >= first; --j)
+            {
+                rows.insert(anchor, target.at(j));
+                model.referenceItem(target.at(j));
+            }
+            model.endInsertRows();
+            for(const T& skippedItem : skipped)
+                positions[skippedItem] += i - first + 1;
+            i = first - 1;
+            continue;
+        }
+        if(position > anchor)
+        {
+            model.beginMoveRows(QModelIndex(), position, position, QModelIndex(), anchor);
+            rows.move(position, anchor);
+            model.endMoveRows();
+            skipped.removeOne(item);
+            for(const T& skippedItem : skipped)
+            {
+                if(positions.value(skippedItem) < position)
+                    ++positions[skippedItem];
+            }
+        }
+        else if(stable.contains(item) || position == anchor - 1)
+        {
+            for(int j = position + 1; j < anchor; ++j)
+                skipped.append(rows.at(j));
+            anchor = position;
+        }
+        else
+        {
+            model.beginMoveRows(QModelIndex(), position, position, QModelIndex(), anchor);
+            rows.move(position, anchor - 1);
+            model.endMoveRows();
+            for(int j = position; j < anchor - 1; ++j)
+                positions[rows.at(j)] = j;
+            --anchor;
+        }
+        --i;
+    }
+    return true;
+}
+
+} // namespace
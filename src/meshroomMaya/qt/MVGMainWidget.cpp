@@ -2,6 +2,7 @@
 #include "meshroomMaya/qt/QmlInstantCoding.hpp"
 //#include "meshroomMaya/qt/QWheelArea.hpp"
 #include "meshroomMaya/maya/MVGMayaUtil.hpp"
+#include "meshroomMaya/qt/MVGCameraListModel.hpp"
 #include "meshroomMaya/qt/MVGCameraWrapper.hpp"
 #include "meshroomMaya/qt/MVGCameraSetWrapper.hpp"
 #include <QFocusEvent>
@@ -19,6 +20,7 @@ MVGMainWidget::MVGMainWidget(QWidget* parent)
 
     qmlRegisterType<MVGCameraWrapper>();
     qmlRegisterType<QObjectListModel>();
+    qmlRegisterType<MVGCameraListModel>();
     qmlRegisterType<MVGCameraSetWrapper>();
 
     _view = new QQuickWidget(parent);
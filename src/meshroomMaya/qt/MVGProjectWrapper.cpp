@@ -1,12 +1,17 @@
 #include "meshroomMaya/qt/MVGProjectWrapper.hpp"
 #include "meshroomMaya/version.hpp"
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
 #include "MVGCameraSetWrapper.hpp"
 #include "meshroomMaya/qt/MVGCameraWrapper.hpp"
 #include "meshroomMaya/qt/MVGMeshWrapper.hpp"
+#include "meshroomMaya/qt/MVGImageMetadataIndex.hpp"
 #include "meshroomMaya/maya/MVGMayaUtil.hpp"
 #include "meshroomMaya/core/MVGLog.hpp"
 #include "meshroomMaya/core/MVGPointCloud.hpp"
+#include "meshroomMaya/core/MVGProjectionCache.hpp"
+#include "meshroomMaya/core/MVGProjectCacheFile.hpp"
 #include "meshroomMaya/maya/context/MVGContextCmd.hpp"
 #include "meshroomMaya/maya/context/MVGContext.hpp"
 #include "meshroomMaya/maya/context/MVGMoveManipulator.hpp"
@@ -26,6 +31,9 @@
 #include <maya/MItSelectionList.h>
 #include <maya/MObjectSetMessage.h>
 #include <maya/MDagModifier.h>
+#include <maya/MDoubleArray.h>
+#include <algorithm>
+#include <iterator>
 
 namespace meshroomMaya
 {
@@ -33,46 +41,88 @@ namespace meshroomMaya
 namespace  // Utility functions
 {
 
+/// Number of neighbour camera images loaded in advance when a camera is set to a view
+static const size_t PREFETCHED_IMAGES_COUNT = 2;
+
 /**
- * Give the number of occurrences of each element in the given sets.
+ * Identify the data a project cache file is built from.
  *
- * @param sets the sets to consider
- * @return a map element => count
+ * @param abcFilePath the abc file of the project
+ * @param cameraIds the view ids of the cameras of the scene
+ * @param source the abc file size, modification date and camera ids hash
+ * @return false if the abc file can't be found
  */
-template <typename T>
-std::map<T, int> countElements(const std::vector< std::set<T> >& sets)
+bool getProjectCacheSource(const QString& abcFilePath, const std::vector<int>& cameraIds,
+                           MVGProjectCacheFile::Source& source)
 {
-    std::map<T, int> idWeights;
-    for(const auto& set : sets)
+    const QFileInfo abcFileInfo(abcFilePath);
+    if(abcFilePath.isEmpty() || !abcFileInfo.exists())
+        return false;
+    source.byteSize = abcFileInfo.size();
+    source.lastModified = abcFileInfo.lastModified().toMSecsSinceEpoch();
+    source.camerasHash = MVGProjectCacheFile::hashCameraIds(cameraIds);
+    return true;
+}
+
+/**
+ * Returns the elements common to at least two of the given sorted ranges.
+ *
+ * @param ranges the sorted ranges to consider
+ * @return the sorted common elements
+ */
+std::vector<int> commonElements(const std::vector<MVGVisibilityGraph::Range>& ranges)
+{
+    std::vector<int> common;
+    if(ranges.size() < 2)
+        return common;
+    std::set_intersection(ranges[0].begin(), ranges[0].end(), ranges[1].begin(), ranges[1].end(),
+                          std::back_inserter(common));
+    if(ranges.size() == 2)
+        return common;
+    // more than two views: merge each range with the union of the previous ones
+    std::vector<int> seen, merged;
+    std::set_union(ranges[0].begin(), ranges[0].end(), ranges[1].begin(), ranges[1].end(),
+                   std::back_inserter(seen));
+    for(size_t i = 2; i < ranges.size(); ++i)
     {
-        for(const auto& elt : set)
-        {
-            if(idWeights.find(elt) != idWeights.end())
-                idWeights[elt]++;
-            else
-                idWeights[elt] = 1;
-        }
+        merged.clear();
+        std::set_intersection(seen.begin(), seen.end(), ranges[i].begin(), ranges[i].end(),
+                              std::back_inserter(merged));
+        std::vector<int> newCommon;
+        std::set_union(common.begin(), common.end(), merged.begin(), merged.end(),
+                       std::back_inserter(newCommon));
+        common.swap(newCommon);
+        merged.clear();
+        std::set_union(seen.begin(), seen.end(), ranges[i].begin(), ranges[i].end(),
+                       std::back_inserter(merged));
+        seen.swap(merged);
     }
-    return idWeights;
+    return common;
 }
 
 /**
- * Returns the intersection (common elements) of the given sets.
+ * Gather point positions from the point cloud store, transformed by the given matrix.
  *
- * @param sets the sets to consider
- * @return the intersection of all the sets
+ * @param store the point cloud store
+ * @param first, last the range of store indexes to gather
+ * @param matrix the transformation to apply
+ * @param array the resulting points
  */
-template <typename T>
-std::set<T> setsIntersection(const std::vector< std::set<T> >& sets)
-{
-    std::set<T> intersection;
-    const auto weights = countElements(sets);
-    for(const auto& elt : weights)
+void gatherPoints(const MVGPointCloudStore& store, const int* first, const int* last,
+                  const MMatrix& matrix, MPointArray& array)
+{
+    const double* x = store.getXData();
+    const double* y = store.getYData();
+    const double* z = store.getZData();
+    array.setLength(last - first);
+    unsigned int count = 0;
+    for(const int* it = first; it != last; ++it)
     {
-        if(elt.second > 1)
-            intersection.insert(elt.first);
+        if(*it < 0 || static_cast<size_t>(*it) >= store.size())
+            continue;
+        array[count++] = matrix * MPoint(x[*it], y[*it], z[*it]);
     }
-    return intersection;
+    array.setLength(count);
 }
 
 }
@@ -83,7 +133,7 @@ _currentCameraSetId(0),
 _particleSelectionAccuracy(25),
 _filterPoints(false),
 _pointsFilteringThreshold(1),
-_defaultCameraSet(new MVGCameraSetWrapper("- ALL -", this)),
+_defaultCameraSet(new MVGCameraSetWrapper(_cameraRecords, "- ALL -", this)),
 _currentCameraSet(_defaultCameraSet),
 _particleSelectionCameraSet(nullptr),
 _cameraPointsLocatorCB(0)
@@ -240,7 +290,7 @@ void MVGProjectWrapper::setUseParticleSelection(bool value)
     if(value)
     {
         // Create a temporary set for particle selection
-        _particleSelectionCameraSet = new MVGCameraSetWrapper(particleSetName);
+        _particleSelectionCameraSet = new MVGCameraSetWrapper(_cameraRecords, particleSetName);
         _cameraSets.append(_particleSelectionCameraSet);
         // Use selection set as current set
         setCurrentCameraSet(_particleSelectionCameraSet);
@@ -279,19 +329,8 @@ void MVGProjectWrapper::updateParticleSelection(const std::set<int>& selection)
         return;
 
     _particleSelection = selection;
-    _selectionScorePerCamera.clear();
-
-    for(const auto& pointId : _particleSelection)
-    {
-        if(!_camerasPerPoint.count(pointId))
-            continue;
-        for(auto* camWrapper : _camerasPerPoint[pointId])
-        {
-            if(!_selectionScorePerCamera.count(camWrapper))
-                _selectionScorePerCamera[camWrapper] = 0;
-            _selectionScorePerCamera[camWrapper]++;
-        }
-    }
+    const std::vector<int> pointIds(_particleSelection.begin(), _particleSelection.end());
+    MVGCamera::getVisibilityGraph().countPointsPerCamera(pointIds, _selectionScorePerCamera);
     Q_EMIT particleSelectionCountChanged();
     updateCamerasFromParticleSelection(true);
 }
@@ -325,35 +364,47 @@ void MVGProjectWrapper::updateParticlesOpacity()
     if(!pc.isValid())
         return;
 
+    // Store indexes match the particle indexes
+    const size_t nbParticles = MVGPointCloud::getStore().size();
+    std::vector<unsigned char> opacity(nbParticles, 1);
     if(_filterPoints)
     {
-        // Set opacity to 0 for all particles
-        pc.setOpacity(0);
-        // set opacity to 1 for particles visible by cams in current set
-        std::set<int> indices;
-        std::map<int, int> indexScore;
-        MIntArray array;
-        for(auto* wrapper : _currentCameraSet->getCameras()->asQList<MVGCameraWrapper>())
-        {
-
-            wrapper->getCamera().getVisibleIndexes(array);
-            for(unsigned int i=0; i < array.length(); ++i)
-            {
-                indexScore[array[i]]++;
-            }
-        }
-        array.clear();
-        for(const auto& indexToScore : indexScore)
-        {
-            if(indexToScore.second > _pointsFilteringThreshold)
-                array.append(indexToScore.first);
-        }
-        pc.setOpacity(array, 1.0);
+        // Set opacity to 1 for particles visible by enough cams in current set
+        const std::vector<int>& scores = getPointsScore(_currentCameraSet);
+        for(size_t i = 0; i < nbParticles; ++i)
+            opacity[i] = i < scores.size() && scores[i] > _pointsFilteringThreshold;
     }
+
+    // Only write the attribute if the result differs from the last applied one
+    if(opacity == _particlesOpacity)
+        return;
+    MDoubleArray values(nbParticles);
+    for(size_t i = 0; i < nbParticles; ++i)
+        values[i] = opacity[i];
+    if(pc.setOpacity(values))
+        _particlesOpacity.swap(opacity);
     else
+        _particlesOpacity.clear();
+}
+
+const std::vector<int>& MVGProjectWrapper::getPointsScore(MVGCameraSetWrapper* cameraSet)
+{
+    const QList<int>& cameras = cameraSet->getCameras()->getCameras();
+
+    // Scores only depend on the set members
+    PointsScore& pointsScore = _pointsScorePerCameraSet[cameraSet];
+    if(pointsScore.cameras == cameras && !pointsScore.scores.empty())
+        return pointsScore.scores;
+
+    const MVGVisibilityGraph& visibilityGraph = MVGCamera::getVisibilityGraph();
+    pointsScore.cameras = cameras;
+    pointsScore.scores.assign(visibilityGraph.getPointsCount(), 0);
+    for(const int camera : pointsScore.cameras)
     {
-        pc.setOpacity(1.0);
+        for(const int pointId : _cameraRecords.getCamera(camera).getVisiblePoints())
+            pointsScore.scores[pointId]++;
     }
+    return pointsScore.scores;
 }
 
 QString MVGProjectWrapper::openFileDialog() const
@@ -495,20 +546,13 @@ void MVGProjectWrapper::loadABC(const QString& abcFilePath)
     status = MVGMayaUtil::getIntArrayAttribute(pointCloud, "mvg_visibilityIds", visibilityIDsArray);
     CHECK_RETURN(status)
 
-    int k = 0;
-    std::map<int, MIntArray> itemsPerCam;
-    // Browse 3D points
-    for(int j = 0; j < visibilitySizeArray.length(); ++j)
-    {
-        int nbView = visibilitySizeArray[j];
-        int lastPosition = k + (nbView - 1) * 2;
-        // Browse visibility
-        for(; k < lastPosition + 1; k += 2)
-        {
-            int viewID = visibilityIDsArray[k];
-            itemsPerCam[viewID].append(j);
-        }
-    }
+    // Observations are stored as (viewID, featureID) pairs, grouped by 3D point
+    MVGVisibilityGraph visibilityGraph;
+    if(visibilitySizeArray.length() > 0 && visibilityIDsArray.length() > 0)
+        visibilityGraph.buildFromPointVisibility(&visibilitySizeArray[0],
+                                                 visibilitySizeArray.length(),
+                                                 &visibilityIDsArray[0],
+                                                 visibilityIDsArray.length(), 2);
 
     // Cameras
     if(cameraGroupPath.childCount() == 0)
@@ -525,8 +569,9 @@ void MVGProjectWrapper::loadABC(const QString& abcFilePath)
         MDagPath cameraDagPath = cameras[i];
         if(cameraDagPath.apiType() != MFn::kCamera)
             continue;
-        MVGCamera::create(cameraDagPath, itemsPerCam);
+        MVGCamera::create(cameraDagPath, visibilityGraph);
     }
+    MVGCamera::setVisibilityGraph(visibilityGraph);
 
     // Set images paths
     cmd.format("from meshroomMaya import camera;\n"
@@ -568,14 +613,15 @@ void MVGProjectWrapper::addCamerasToIHMSelection(const QStringList& selectedCame
     for(QStringList::const_iterator it = selectedCameraNames.begin();
         it != selectedCameraNames.end(); ++it)
     {
-        if(_camerasByName.count(it->toStdString()) == 0)
+        const auto cameraIt = _camerasByName.find(it->toStdString());
+        if(cameraIt == _camerasByName.end())
             continue;
-        MVGCameraWrapper* camera = _camerasByName[it->toStdString()];
-        camera->setIsSelected(true);
+        const int camera = cameraIt->second;
+        _cameraRecords.setSelected(camera, true);
         _selectedCameras.append(*it);
         // Replace listView and set image in first viewort
         // TODO : let the user define in which viewport he wants to display the selected camera
-        if(center && camera->getDagPathAsString() == selectedCameraNames[0])
+        if(center && it == selectedCameraNames.begin())
         {
             setCameraToView(camera, static_cast<MVGPanelWrapper*>(_panelList.get(0))->getName());
             const auto idx = _currentCameraSet->getCameras()->indexOf(camera);
@@ -669,36 +715,87 @@ void MVGProjectWrapper::deleteCameraSet(MVGCameraSetWrapper* setWrapper)
 }
 
 void MVGProjectWrapper::setCameraToView(MVGCameraWrapper* cameraWrapper, const QString& viewName)
+{
+    setCameraToView(cameraWrapper ? cameraWrapper->getCameraIndex() : -1, viewName);
+}
+
+void MVGProjectWrapper::setCameraToView(const int camera, const QString& viewName)
 {
     // Push command
     _project.pushLoadCurrentImagePlaneCommand(viewName.toStdString());
     // Set UI
-    for(const auto& cam : _camerasByName)
+    for(int i = 0; i < _cameraRecords.size(); ++i)
     {
-        MVGCameraWrapper* camWrapper = cam.second;
-        if(camWrapper->isInView(viewName))
-        {
-            camWrapper->setInView(viewName, false);
-            camWrapper->getCamera().setLocatorCustomColor(false);
-        }
+        if(_cameraRecords.isRemoved(i) || !_cameraRecords.getViews(i).contains(viewName))
+            continue;
+        _cameraRecords.setInView(i, viewName, false);
+        _cameraRecords.getCamera(i).setLocatorCustomColor(false);
     }
 
     // Update active camera
-    _activeCameraNameByView[viewName.toStdString()] = cameraWrapper ? cameraWrapper->getDagPathAsString().toStdString() : "";
+    _activeCameraNameByView[viewName.toStdString()] =
+        camera >= 0 ? _cameraRecords.getCamera(camera).getDagPathAsString() : "";
 
     // Update data from new configuration
     for(const auto& camByView : _activeCameraNameByView)
     {
         const QString view = QString::fromStdString(camByView.first);
-        MVGCameraWrapper* camWrapper = cameraFromViewName(view);
-        if(!camWrapper)
+        const int viewCamera = cameraFromViewName(view);
+        if(viewCamera < 0)
             return;
-        camWrapper->setInView(view, true);
+        _cameraRecords.setInView(viewCamera, view, true);
         const MColor color = MVGMayaUtil::fromQColor(panelFromViewName(view)->getColor());
-        camWrapper->getCamera().setLocatorCustomColor(true, color);
+        _cameraRecords.getCamera(viewCamera).setLocatorCustomColor(true, color);
     }
 
     updatePointsVisibility();
+    prefetchNeighbourImages(camera);
+}
+
+void MVGProjectWrapper::prefetchNeighbourImages(const int camera)
+{
+    // prefetches queued for the previous cameras are not relevant anymore
+    const unsigned int generation = _project.startImagePrefetch();
+    if(camera < 0)
+        return;
+    // Score other cameras by number of points shared with this camera
+    const MVGVisibilityGraph& visibilityGraph = MVGCamera::getVisibilityGraph();
+    std::vector<int> sharedPointsPerCamera(visibilityGraph.getCamerasCount(), 0);
+    for(const int pointId : _cameraRecords.getCamera(camera).getVisiblePoints())
+    {
+        for(const int cameraIndex : visibilityGraph.getPointCameras(pointId))
+            sharedPointsPerCamera[cameraIndex]++;
+    }
+
+    // Keep cameras that are not displayed in a view, and whose image is not already cached
+    const MVGImageCache& imageCache = _project.getImageCache();
+    std::vector<std::pair<int, int>> candidates;
+    for(size_t i = 0; i < sharedPointsPerCamera.size() && i < _camerasByGraphIndex.size(); ++i)
+    {
+        const int other = _camerasByGraphIndex[i];
+        if(sharedPointsPerCamera[i] == 0 || other < 0 || other == camera)
+            continue;
+        const std::string dagPath = _cameraRecords.getCamera(other).getDagPathAsString();
+        bool isInView = false;
+        for(const auto& camByView : _activeCameraNameByView)
+            isInView |= (camByView.second == dagPath);
+        if(isInView)
+            continue;
+        // image cache key: transform partial path, as "modelPanel -q -camera"
+        MDagPath transformPath = _cameraRecords.getCamera(other).getDagPath();
+        transformPath.pop();
+        if(!imageCache.contains(transformPath.partialPathName().asChar()))
+            candidates.emplace_back(sharedPointsPerCamera[i], other);
+    }
+
+    // Push the load of the best ranked ones after the load of the current image planes
+    const size_t count = std::min(candidates.size(), PREFETCHED_IMAGES_COUNT);
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                      [](const std::pair<int, int>& a, const std::pair<int, int>& b)
+                      { return a.first > b.first; });
+    for(size_t i = 0; i < count; ++i)
+        _project.pushPrefetchImagePlaneCommand(
+            _cameraRecords.getCamera(candidates[i].second).getDagPathAsString(), generation);
 }
 
 void MVGProjectWrapper::setPerspFromCamera(MVGCameraWrapper *wrapper)
@@ -707,16 +804,19 @@ void MVGProjectWrapper::setPerspFromCamera(MVGCameraWrapper *wrapper)
     MDagPath perspPath;
     CHECK_RETURN(MVGMayaUtil::getDagPathByName("persp", perspPath));
     MFnTransform perspTransform(perspPath);
+    const int camera = wrapper ? wrapper->getCameraIndex() : -1;
+    if(camera < 0)
+        return;
     // Apply transform from the given camera
-    perspTransform.set(wrapper->getCamera().getDagPath().inclusiveMatrix());
+    perspTransform.set(_cameraRecords.getCamera(camera).getDagPath().inclusiveMatrix());
 }
 
 void MVGProjectWrapper::swapViews()
 {
-    MVGCameraWrapper* lPanelCam = cameraFromViewName("mvgLPanel");
-    MVGCameraWrapper* rPanelCam = cameraFromViewName("mvgRPanel");
-    if(rPanelCam) setCameraToView(rPanelCam, "mvgLPanel");
-    if(lPanelCam) setCameraToView(lPanelCam, "mvgRPanel");
+    const int lPanelCam = cameraFromViewName("mvgLPanel");
+    const int rPanelCam = cameraFromViewName("mvgRPanel");
+    if(rPanelCam >= 0) setCameraToView(rPanelCam, "mvgLPanel");
+    if(lPanelCam >= 0) setCameraToView(lPanelCam, "mvgRPanel");
 }
 
 void MVGProjectWrapper::initCameraPointsLocator()
@@ -736,31 +836,20 @@ void MVGProjectWrapper::initCameraPointsLocator()
 
 void MVGProjectWrapper::updatePointsVisibility()
 {
-    std::vector< std::set<int> > pointsSets;
-    pointsSets.reserve(_activeCameraNameByView.size());
-    std::map< std::string, std::set<int>* > pointsPerCamera;
+    std::vector<MVGVisibilityGraph::Range> pointsRanges;
+    pointsRanges.reserve(_activeCameraNameByView.size());
     for(const auto& camByView : _activeCameraNameByView)
     {
-        MVGCameraWrapper* camWrapper = cameraFromViewName(QString::fromStdString(camByView.first));
-        if(!camWrapper)
+        const int camera = cameraFromViewName(QString::fromStdString(camByView.first));
+        if(camera < 0)
             return;
-        std::set<int> visibility;
-        MIntArray visibleIndexes;
-        camWrapper->getCamera().getVisibleIndexes(visibleIndexes);
-        for(unsigned int i = 0; i < visibleIndexes.length(); ++i)
-            visibility.insert(visibleIndexes[i]);
-        pointsSets.push_back(visibility);
-        // pointsSets won't be resized (because reserved);
-        // we can use pointers to avoid data duplication
-        pointsPerCamera[camByView.second] = &pointsSets.back();
+        // sorted point ids, no copy
+        pointsRanges.push_back(_cameraRecords.getCamera(camera).getVisiblePoints());
     }
 
-    // Remove common points from individual camera points lists
+    // Common points are removed from individual camera points lists
     // to avoid z-fighting when drawing them
-    const std::set<int> intersection = setsIntersection(pointsSets);
-    for(const auto& cameraPoints : pointsPerCamera)
-        for(const auto& point : intersection)
-            cameraPoints.second->erase(point);
+    const std::vector<int> intersection = commonElements(pointsRanges);
 
     MObject locator;
     MStatus status;
@@ -770,33 +859,36 @@ void MVGProjectWrapper::updatePointsVisibility()
     status = MDagPath::getAPathTo(locator, locatorPath);
     CHECK_RETURN(status)
 
-    std::vector<MVGPointCloudItem> allPoints;
-    MVGPointCloud pointCloud(MVGProject::_CLOUD);
-    pointCloud.getItems(allPoints);
+    const MVGPointCloudStore& store = MVGPointCloud::getStore();
 
-    // PointCloudItem positions are in world space;
+    // Store positions are in world space;
     // multiply them by the locator inverse matrix to be independent from the locator transform
     const MMatrix locatorInverseMatrix = locatorPath.inclusiveMatrixInverse().transpose();
 
     // Fill locator points attributes (based on panel name)
     // TODO: make it more generic
+    std::vector<int> cameraPoints;
+    size_t rangeIndex = 0;
     for(const auto& camByView : _activeCameraNameByView)
     {
         const std::string& camName = camByView.second;
         if(camName.empty())
             return;
         const std::string& attrName = camByView.first + "Points";
-        const auto& cameraPoints = *(pointsPerCamera[camName]);
+        const MVGVisibilityGraph::Range& range = pointsRanges[rangeIndex++];
+        cameraPoints.clear();
+        std::set_difference(range.begin(), range.end(), intersection.begin(), intersection.end(),
+                            std::back_inserter(cameraPoints));
         MPointArray array;
-        for(const auto& point : cameraPoints)
-            array.append(locatorInverseMatrix * allPoints[point]._position);
+        gatherPoints(store, cameraPoints.data(), cameraPoints.data() + cameraPoints.size(),
+                     locatorInverseMatrix, array);
         MVGMayaUtil::setPointArrayAttribute(locator, attrName.c_str(), array);
     }
 
     { // Common points
         MPointArray array;
-        for(const auto& point : intersection)
-            array.append(locatorInverseMatrix * allPoints[point]._position);
+        gatherPoints(store, intersection.data(), intersection.data() + intersection.size(),
+                     locatorInverseMatrix, array);
         MVGMayaUtil::setPointArrayAttribute(locator, "mvgCommonPoints", array);
     }
 }
@@ -804,42 +896,44 @@ void MVGProjectWrapper::updatePointsVisibility()
 void MVGProjectWrapper::setCamerasNear(const double near)
 {
     // TODO : undoable ?
-    for(std::map<std::string, MVGCameraWrapper*>::const_iterator it = _camerasByName.begin();
+    for(std::map<std::string, int>::const_iterator it = _camerasByName.begin();
         it != _camerasByName.end(); ++it)
-        it->second->getCamera().setNear(near);
+        _cameraRecords.getCamera(it->second).setNear(near);
 }
 void MVGProjectWrapper::setCamerasFar(const double far)
 {
     // TODO : undoable ?
-    for(std::map<std::string, MVGCameraWrapper*>::const_iterator it = _camerasByName.begin();
+    for(std::map<std::string, int>::const_iterator it = _camerasByName.begin();
         it != _camerasByName.end(); ++it)
-        it->second->getCamera().setFar(far);
+        _cameraRecords.getCamera(it->second).setFar(far);
 }
 
 void MVGProjectWrapper::setCamerasDepth(const double depth)
 {
-    for(std::map<std::string, MVGCameraWrapper*>::const_iterator it = _camerasByName.begin();
+    for(std::map<std::string, int>::const_iterator it = _camerasByName.begin();
         it != _camerasByName.end(); ++it)
-        it->second->getCamera().setImagePlaneDepth(depth);
+        _cameraRecords.getCamera(it->second).setImagePlaneDepth(depth);
 }
 
 void MVGProjectWrapper::setCameraLocatorScale(const double scale)
 {
     // TODO : undoable ?
-    for(std::map<std::string, MVGCameraWrapper*>::const_iterator it = _camerasByName.begin();
+    for(std::map<std::string, int>::const_iterator it = _camerasByName.begin();
         it != _camerasByName.end(); ++it)
-        it->second->getCamera().setLocatorScale(scale);
+        _cameraRecords.getCamera(it->second).setLocatorScale(scale);
 }
 
 void MVGProjectWrapper::selectCamerasPoints()
 {
     std::set<int> points;
-    MIntArray array;
     for(const auto& camName : _selectedCameras)
     {
-        _camerasByName[camName.toStdString()]->getCamera().getVisibleIndexes(array);
-        for(unsigned int i=0; i<array.length(); ++i)
-            points.insert(array[i]);
+        const auto cameraIt = _camerasByName.find(camName.toStdString());
+        if(cameraIt == _camerasByName.end())
+            continue;
+        const MVGVisibilityGraph::Range visibility =
+            _cameraRecords.getCamera(cameraIt->second).getVisiblePoints();
+        points.insert(visibility.begin(), visibility.end());
     }
     // Activate particle selection mode
     setUseParticleSelection(true);
@@ -853,10 +947,8 @@ void MVGProjectWrapper::createCameraSetFromSelection(const QString& name, bool m
 
 void MVGProjectWrapper::duplicateCameraSet(const QString& copyName, MVGCameraSetWrapper* sourceSet, bool makeCurrent)
 {
-    auto cameraList = sourceSet->getCameras()->asQList<MVGCameraWrapper>();
-    QStringList dagPaths;
-    for(auto* wrapper : cameraList)
-        dagPaths.append(wrapper->getDagPathAsString());
+    const MVGCameraListModel* cameras = sourceSet->getCameras();
+    const QStringList dagPaths = cameras->getDagPaths(0, cameras->count() - 1);
     createCameraSetFromDagPaths(copyName, dagPaths, makeCurrent);
 }
 
@@ -893,13 +985,9 @@ void MVGProjectWrapper::clearAllBlindData()
 {
     // Retrieve all meshes
     std::vector<MVGMesh> meshes = MVGMesh::listAllMeshes();
+    // Cache is updated by the edit commands
     for(std::vector<MVGMesh>::iterator it = meshes.begin(); it != meshes.end(); ++it)
         it->unsetAllBlindData();
-
-    // Update cache
-    MString cmd;
-    cmd.format("^1s -e -rebuild ^2s", MVGContextCmd::name, MVGContextCmd::instanceName);
-    MGlobal::executeCommand(cmd);
 }
 
 void MVGProjectWrapper::clear()
@@ -907,16 +995,33 @@ void MVGProjectWrapper::clear()
     _currentCameraSet->highlightLocators(false);
 
     _camerasByName.clear();
+    _camerasByNode.clear();
+    _removedCameras.clear();
     _activeCameraNameByView.clear();
     clearCameraSelection();
 
+    _planeSegmentationTask.cancel();
+    _projectCachePath.clear();
+
     _cameraSetsByName.clear();
     _cameraSets.clear();
+    // Camera sets reference the cameras by index
+    _defaultCameraSet->setCameras(QList<int>());
+    _cameraRecords.clear();
 
     _meshesByName.clear();
     _meshesList.clear();
     _selectedMeshes.clear();
 
+    MVGPointCloud::clearStore();
+    MVGCamera::clearVisibilityGraph();
+    _camerasByGraphIndex.clear();
+    _pointsScorePerCameraSet.clear();
+    _particlesOpacity.clear();
+    MVGProjectionCache::clear();
+    MVGImageMetadataIndex::save();
+    MVGImageMetadataIndex::clear();
+
     if(_cameraPointsLocatorCB)
         MNodeMessage::removeCallback(_cameraPointsLocatorCB);
 
@@ -951,10 +1056,10 @@ void MVGProjectWrapper::clearCameraSelection()
     for(QStringList::const_iterator it = _selectedCameras.begin(); it != _selectedCameras.end();
         ++it)
     {
-        std::map<std::string, MVGCameraWrapper*>::const_iterator foundIt =
+        std::map<std::string, int>::const_iterator foundIt =
             _camerasByName.find(it->toStdString());
         if(foundIt != _camerasByName.end())
-            foundIt->second->setIsSelected(false);
+            _cameraRecords.setSelected(foundIt->second, false);
     }
     _selectedCameras.clear();
     Q_EMIT cameraSelectionCountChanged();
@@ -974,38 +1079,72 @@ void MVGProjectWrapper::clearMeshSelection()
 
 void MVGProjectWrapper::removeCameraFromUI(MObject& camera)
 {
-    MFnCamera fnCam(camera);
-    MDagPath path;
-    fnCam.getPath(path);
-    const std::string camName = path.fullPathName().asChar();
-    // Remove callbacks on this node
-    MMessage::removeCallbacks(_nodeCallbacks[camName]);
-    _nodeCallbacks.erase(camName);
-
-    auto it = _camerasByName.find(camName);
-    if(it == _camerasByName.end())
+    const MObjectHandle handle(camera);
+    auto range = _camerasByNode.equal_range(handle.hashCode());
+    auto it = range.first;
+    while(it != range.second && !(it->second.handle == camera))
+        ++it;
+    if(it == range.second)
+        return;
+    const int cameraIndex = it->second.camera;
+
+    // Keep lookups consistent right away, models are updated once the command is over.
+    // The node entry knows the keys of the camera, the node path may have changed since load.
+    auto nameIt = _camerasByName.find(it->second.name);
+    if(nameIt != _camerasByName.end() && nameIt->second == cameraIndex)
+        _camerasByName.erase(nameIt);
+    const int graphIndex = it->second.graphIndex;
+    if(graphIndex >= 0 && graphIndex < static_cast<int>(_camerasByGraphIndex.size()))
+        _camerasByGraphIndex[graphIndex] = -1;
+    _camerasByNode.erase(it);
+    _cameraRecords.setRemoved(cameraIndex);
+    _pointsScorePerCameraSet.clear();
+    if(_removedCameras.empty())
+        QMetaObject::invokeMethod(this, "flushCameraRemovals", Qt::QueuedConnection);
+    _removedCameras.push_back(cameraIndex);
+}
+
+void MVGProjectWrapper::flushCameraRemovals()
+{
+    if(_removedCameras.empty())
         return;
-    _camerasByName.erase(camName);
+    std::sort(_removedCameras.begin(), _removedCameras.end());
+    const auto isRemoved = [this](const int camera)
+    {
+        return std::binary_search(_removedCameras.begin(), _removedCameras.end(), camera);
+    };
 
-    auto* wrapper = it->second;
-    // Remove all occurences of the wrapper in the camera sets
-    for (MVGCameraSetWrapper* setWrapper : _cameraSets.asQList<MVGCameraSetWrapper>())
+    // Clear the views if needed
+    for(const auto& view : _activeCameraNameByView)
     {
-        const int idx = setWrapper->getCameras()->indexOf(wrapper);
-        if(idx >= 0)
-            setWrapper->getCameras()->removeAt(idx);
+        if(view.second.empty())
+            continue;
+        // removed nodes may not have a valid path anymore, views also know their camera index
+        const QString viewName = QString::fromStdString(view.first);
+        auto it = std::find_if(_removedCameras.begin(), _removedCameras.end(),
+                               [this, &view, &viewName](const int camera)
+                               {
+                                   return _cameraRecords.getViews(camera).contains(viewName) ||
+                                          _cameraRecords.getCamera(camera).getDagPathAsString() ==
+                                              view.second;
+                               });
+        if(it != _removedCameras.end())
+            MVGMayaUtil::clearCameraInView(view.first.c_str());
     }
 
-    // Clear the views if needed
-    MDagPath leftCameraPath, rightCameraPath;
-    MVGMayaUtil::getCameraInView(leftCameraPath, "mvgLPanel");
-    leftCameraPath.extendToShape();
-    if(leftCameraPath.fullPathName() == camName.c_str())
-        MVGMayaUtil::clearCameraInView("mvgLPanel");
-    MVGMayaUtil::getCameraInView(rightCameraPath, "mvgRPanel");
-    rightCameraPath.extendToShape();
-    if(rightCameraPath.fullPathName() == camName.c_str())
-        MVGMayaUtil::clearCameraInView("mvgRPanel");
+    // Remove all occurences of the cameras in the camera sets, in a single model update each
+    for(MVGCameraSetWrapper* setWrapper : _cameraSets.asQList<MVGCameraSetWrapper>())
+    {
+        QList<int> cameras = setWrapper->getCameras()->getCameras();
+        auto last = std::remove_if(cameras.begin(), cameras.end(), isRemoved);
+        if(last == cameras.end())
+            continue;
+        cameras.erase(last, cameras.end());
+        setWrapper->setCameras(cameras);
+    }
+    for(const int camera : _removedCameras)
+        _cameraRecords.releaseWrapper(camera);
+    _removedCameras.clear();
 }
 
 void MVGProjectWrapper::addMeshToUI(const MDagPath& meshPath)
@@ -1037,7 +1176,7 @@ void MVGProjectWrapper::removeMeshFromUI(const MDagPath& meshPath)
 
 void MVGProjectWrapper::addCameraSetToUI(MObject& set, bool makeCurrent)
 {
-    MVGCameraSetWrapper* wrapper = new MVGCameraSetWrapper(set);
+    MVGCameraSetWrapper* wrapper = new MVGCameraSetWrapper(_cameraRecords, set);
     _cameraSetsByName[wrapper->fnSet().name().asChar()] = wrapper;
     _cameraSets.append(wrapper); // model takes ownership
     updateCameraSetWrapperMembers(set);
@@ -1073,6 +1212,8 @@ void MVGProjectWrapper::removeCameraSetFromUI(MObject& set)
     auto* wrapper = _cameraSetsByName[setName];
     if(wrapper == _currentCameraSet)
         setCurrentCameraSetIndex(getCurrentCameraSetIndex()-1);
+    // A new set may be allocated at the same address: don't let it inherit these scores
+    _pointsScorePerCameraSet.erase(wrapper);
     _cameraSetsByName.erase(setName);
     getCameraSets()->remove(wrapper);
 }
@@ -1105,44 +1246,104 @@ void MVGProjectWrapper::setMoveMode(const int mode)
 
 void MVGProjectWrapper::reloadMVGCamerasFromMaya()
 {
+    _planeSegmentationTask.cancel();
     _camerasByName.clear();
+    _camerasByNode.clear();
+    _removedCameras.clear();
     _activeCameraNameByView.clear();
-    _camerasPerPoint.clear();
+    _camerasByGraphIndex.clear();
+    _pointsScorePerCameraSet.clear();
+    _particlesOpacity.clear();
     _cameraSetsByName.clear();
     _cameraSets.clear();
     _selectionScorePerCamera.clear();
+    // Camera sets reference the cameras by index
+    _defaultCameraSet->setCameras(QList<int>());
+
+    // Image dimensions & sizes known from previous sessions
+    MVGImageMetadataIndex::load(MVGImageMetadataIndex::getIndexPath(getProjectDirectory()));
 
     const std::vector<MVGCamera>& cameraList = MVGCamera::getCameras();
-    QObjectList camWrappers;
+    std::vector<int> cameraIds;
+    cameraIds.reserve(cameraList.size());
     for(const auto& camera : cameraList)
+        cameraIds.push_back(camera.getId());
+
+    // Fill point cloud store and visibility graph once for this project,
+    // from the project cache file if it is up to date
+    MVGProjectCacheFile::Source cacheSource;
+    const bool hasCacheSource =
+        getProjectCacheSource(getProjectDirectory(), cameraIds, cacheSource);
+    const std::string cachePath =
+        MVGProjectCacheFile::getCachePath(getProjectDirectory().toStdString());
+    MVGPointCloudStore store;
+    MVGVisibilityGraph cachedVisibilityGraph;
+    MVGPlaneSegmentation cachedPlaneSegmentation;
+    if(hasCacheSource && MVGProjectCacheFile::read(cachePath, cacheSource, store,
+                                                   cachedVisibilityGraph, cachedPlaneSegmentation))
     {
-        MVGCameraWrapper* cameraWrapper = new MVGCameraWrapper(camera);
-        camWrappers.append(cameraWrapper);
-        _camerasByName[camera.getDagPathAsString()] = cameraWrapper;
-        MIntArray indices;
-        camera.getVisibleIndexes(indices);
-        for(unsigned int i = 0; i < indices.length(); ++i)
-        {
-            if(!_camerasPerPoint.count(indices[i]))
-                _camerasPerPoint.emplace(indices[i], std::vector<MVGCameraWrapper*>());
-            _camerasPerPoint[indices[i]].push_back(cameraWrapper);
-        }
+        MVGPointCloud::setStore(store);
+        MVGPointCloud::setPlaneSegmentation(cachedPlaneSegmentation);
+        MVGCamera::setVisibilityGraph(cachedVisibilityGraph);
+    }
+    else
+    {
+        MVGPointCloud pointCloud(MVGProject::_CLOUD);
+        if(pointCloud.isValid())
+            pointCloud.loadStore();
+        else
+            MVGPointCloud::clearStore();
+        // Visibility graph is built at abc import, or from the camera attributes on scene reopen
+        if(hasCacheSource && !MVGProjectCacheFile::write(cachePath, cacheSource,
+                                                         MVGPointCloud::getStore(),
+                                                         MVGCamera::getVisibilityGraph(),
+                                                         MVGPointCloud::getPlaneSegmentation()))
+            LOG_WARNING("Can't write project cache file " << cachePath)
+    }
+    _projectCachePath = hasCacheSource ? cachePath : std::string();
+    _projectCacheSource = cacheSource;
+    // Planes of the point cloud are computed in the background, then saved in the cache file
+    if(MVGPointCloud::getPlaneSegmentation().empty() && !MVGPointCloud::getStore().empty())
+    {
+        _planeSegmentationTask.start(MVGPointCloud::getStore(), MVGPlaneSegmentation::Options(),
+                                     [this]()
+                                     {
+                                         QMetaObject::invokeMethod(this, "applyPlaneSegmentation",
+                                                                   Qt::QueuedConnection);
+                                     });
+    }
+    const MVGVisibilityGraph& visibilityGraph = MVGCamera::getVisibilityGraph();
+    _camerasByGraphIndex.assign(visibilityGraph.getCamerasCount(), -1);
+
+    // Records only hold the camera, other data being read from Maya on first access,
+    // and wrappers are created for the rows displayed by the views
+    _cameraRecords.reset(cameraList);
+    QList<int> cameras;
+    cameras.reserve(static_cast<int>(cameraList.size()));
+    for(size_t i = 0; i < cameraList.size(); ++i)
+    {
+        const MVGCamera& camera = cameraList[i];
+        cameras.append(static_cast<int>(i));
+        const std::string name = camera.getDagPathAsString();
+        _camerasByName[name] = static_cast<int>(i);
+        const int cameraIndex = visibilityGraph.getCameraIndex(cameraIds[i]);
+        if(cameraIndex >= 0)
+            _camerasByGraphIndex[cameraIndex] = static_cast<int>(i);
         MObject cam = camera.getObject();
-        // Lock cam node to avoid manipulation errors
+        // Lock cam node to avoid manipulation errors (lock state is saved with the scene)
         MFnDagNode dagCam(cam);
-        dagCam.setLocked(true);
-        MCallbackId cbId = MNodeMessage::addNodePreRemovalCallback(cam, [](MObject& node, void* projectWrapper) {
-            auto* project = static_cast<MVGProjectWrapper*>(projectWrapper);
-            project->removeCameraFromUI(node);
-        }, static_cast<void*>(this));
-        _nodeCallbacks[camera.getName()].append(cbId);
+        if(!dagCam.isLocked())
+            dagCam.setLocked(true);
+        const MObjectHandle handle(cam);
+        const CameraNode node = {handle, static_cast<int>(i), name, cameraIndex};
+        _camerasByNode.emplace(handle.hashCode(), node);
     }
     // TODO : Camera selection
 
     // Camera Sets
     {
     // - default set with all cams
-    _defaultCameraSet->setCameraWrappers(camWrappers); // model takes ownership of camera wrappers
+    _defaultCameraSet->setCameras(cameras);
     _cameraSets.append(_defaultCameraSet);
     setCurrentCameraSet(_defaultCameraSet);
     // - sets from maya scene
@@ -1152,17 +1353,34 @@ void MVGProjectWrapper::reloadMVGCamerasFromMaya()
     }
 }
 
+void MVGProjectWrapper::applyPlaneSegmentation()
+{
+    MVGPlaneSegmentation segmentation;
+    if(!_planeSegmentationTask.takeResult(segmentation))
+        return;
+    MVGPointCloud::setPlaneSegmentation(segmentation);
+    const MVGPlaneSegmentation& planeSegmentation = MVGPointCloud::getPlaneSegmentation();
+    if(planeSegmentation.empty())
+        return;
+    LOG_INFO(planeSegmentation.getPlanesCount() << " planes found in the point cloud")
+    if(!_projectCachePath.empty() &&
+       !MVGProjectCacheFile::write(_projectCachePath, _projectCacheSource,
+                                   MVGPointCloud::getStore(), MVGCamera::getVisibilityGraph(),
+                                   planeSegmentation))
+        LOG_WARNING("Can't write project cache file " << _projectCachePath)
+}
+
 void MVGProjectWrapper::updatePanelColor(const QString& viewName)
 {
     // Update panel's color
     MVGPanelWrapper* panel = panelFromViewName(viewName);
     panel->onColorAttributeChanged();
     // Update camera locator's color if any
-    MVGCameraWrapper* camWrapper = cameraFromViewName(viewName);
-    if(!camWrapper)
+    const int camera = cameraFromViewName(viewName);
+    if(camera < 0)
         return;
     const MColor color = MVGMayaUtil::fromQColor(panelFromViewName(viewName)->getColor());
-    camWrapper->getCamera().setLocatorCustomColor(true, color);
+    _cameraRecords.getCamera(camera).setLocatorCustomColor(true, color);
 }
 
 void MVGProjectWrapper::updateCamerasFromParticleSelection(bool force)
@@ -1170,39 +1388,50 @@ void MVGProjectWrapper::updateCamerasFromParticleSelection(bool force)
     if(!useParticleSelection())
         return;
 
-    QObjectList filteredCams;
+    QList<int> filteredCams;
 
     if(!_particleSelection.empty())
     {
-        const auto maxIt = std::max_element(_selectionScorePerCamera.begin(), _selectionScorePerCamera.end(),
-                [](const std::pair<MVGCameraWrapper*, int>& p1, const std::pair<MVGCameraWrapper*, int>& p2)
-                {
-                    return p1.second < p2.second;
-                });
-        setParticleMaxAccuracy(maxIt->second);
+        // Cameras seeing at least one selected particle, as (score, camera index)
+        std::vector<std::pair<int, int>> scores;
+        for(size_t i = 0; i < _selectionScorePerCamera.size() && i < _camerasByGraphIndex.size();
+            ++i)
+        {
+            if(_selectionScorePerCamera[i] > 0 && _camerasByGraphIndex[i] >= 0)
+                scores.emplace_back(_selectionScorePerCamera[i], i);
+        }
+        int maxScore = 0;
+        for(const auto& score : scores)
+            maxScore = std::max(maxScore, score.first);
+        setParticleMaxAccuracy(maxScore);
         const auto minAccuracy = getParticleMaxAccuracy() * (_particleSelectionAccuracy/100.0f);
 
         // Keep only cameras meeting the minimum score requirement
-        for(const auto& elt : _selectionScorePerCamera)
-        {
-            if(elt.second >= minAccuracy)
-                filteredCams.append(elt.first);
-        }
+        const auto scoresEnd = std::partition(scores.begin(), scores.end(),
+                                              [minAccuracy](const std::pair<int, int>& score)
+                                              {
+                                                  return score.first >= minAccuracy;
+                                              });
+        const int filteredCount = scoresEnd - scores.begin();
 
         // Unless forced to update, same size here means no changes
-        if(!force && filteredCams.size() == _particleSelectionCameraSet->getCameras()->size())
+        if(!force && filteredCount == _particleSelectionCameraSet->getCameras()->count())
             return;
 
-        // Sort model by score
-        std::sort(filteredCams.begin(), filteredCams.end(),
-                [this](QObject* a, QObject* b){
-                   return _selectionScorePerCamera[static_cast<MVGCameraWrapper*>(a)] > _selectionScorePerCamera[static_cast<MVGCameraWrapper*>(b)];
-                });
+        // Sort model by score, best first
+        std::sort(scores.begin(), scoresEnd,
+                  [](const std::pair<int, int>& a, const std::pair<int, int>& b)
+                  {
+                      return a.first > b.first || (a.first == b.first && a.second < b.second);
+                  });
+        filteredCams.reserve(filteredCount);
+        for(auto it = scores.begin(); it != scoresEnd; ++it)
+            filteredCams.append(_camerasByGraphIndex[it->second]);
     }
 
     _particleSelectionCameraSet->highlightLocators(false);
-    // Update particle selection set's camera wrappers
-    _particleSelectionCameraSet->setCameraWrappers(filteredCams);
+    // Update particle selection set's cameras
+    _particleSelectionCameraSet->setCameras(filteredCams);
     _particleSelectionCameraSet->highlightLocators(true);
 }
 
@@ -1215,7 +1444,7 @@ void MVGProjectWrapper::updateCameraSetWrapperMembers(const MObject &set)
     wrapper->fnSet().getMembers(list, false);
     MItSelectionList selectionIt(list);
     MDagPath path;
-    QObjectList cams;
+    QList<int> cams;
     for (; !selectionIt.isDone(); selectionIt.next())
     {
         selectionIt.getDagPath(path);
@@ -1223,11 +1452,14 @@ void MVGProjectWrapper::updateCameraSetWrapperMembers(const MObject &set)
         if(path.apiType() == MFn::kCamera)
         {
             MVGCamera cam(path);
-            if(cam.isValid() && _camerasByName.count(cam.getDagPathAsString()))
-                cams.append(_camerasByName[cam.getDagPathAsString()]);
+            if(!cam.isValid())
+                continue;
+            const auto cameraIt = _camerasByName.find(cam.getDagPathAsString());
+            if(cameraIt != _camerasByName.end())
+                cams.append(cameraIt->second);
         }
     }
-    wrapper->setCameraWrappers(cams);
+    wrapper->setCameras(cams);
 }
 
 void MVGProjectWrapper::setCurrentCameraSet(MVGCameraSetWrapper* setWrapper)
@@ -1254,12 +1486,13 @@ void MVGProjectWrapper::setCurrentCameraSet(MVGCameraSetWrapper* setWrapper)
         Q_EMIT currentCameraSetIndexChanged();
 }
 
-MVGCameraWrapper* MVGProjectWrapper::cameraFromViewName(const QString& viewName)
+int MVGProjectWrapper::cameraFromViewName(const QString& viewName)
 {
     const std::string camName = _activeCameraNameByView[viewName.toStdString()];
-    if(camName.empty())
-        return NULL;
-    return _camerasByName[camName];
+    const auto cameraIt = _camerasByName.find(camName);
+    if(cameraIt == _camerasByName.end())
+        return -1;
+    return cameraIt->second;
 }
 
 MVGPanelWrapper* MVGProjectWrapper::panelFromViewName(const QString& viewName)
@@ -2,13 +2,18 @@
 
 #include "meshroomMaya/qt/QObjectListModel.hpp"
 #include "meshroomMaya/qt/MVGPanelWrapper.hpp"
+#include "meshroomMaya/qt/MVGCameraRecords.hpp"
 #include "meshroomMaya/qt/MVGCameraWrapper.hpp"
 #include "meshroomMaya/qt/MVGCameraSetWrapper.hpp"
 #include "meshroomMaya/qt/MVGMeshWrapper.hpp"
 #include "meshroomMaya/core/MVGProject.hpp"
+#include "meshroomMaya/core/MVGProjectCacheFile.hpp"
+#include "meshroomMaya/core/MVGPlaneSegmentation.hpp"
 #include "maya/MDistance.h"
+#include "maya/MObjectHandle.h"
 #include <QObject>
 #include <set>
+#include <unordered_map>
 
 namespace meshroomMaya
 {
@@ -194,7 +199,8 @@ public:
     void clearCameraSelection();
     void clearMeshSelection();
     // UI
-    void removeCameraFromUI(MObject& cameraPath);
+    /// Queue the removal of the camera node, the UI being updated once per command
+    void removeCameraFromUI(MObject& camera);
     void addMeshToUI(const MDagPath& meshPath);
     void removeMeshFromUI(const MDagPath& meshPath);
     void addCameraSetToUI(MObject& set, bool makeCurrent=false);
@@ -210,17 +216,29 @@ public:
 protected Q_SLOTS:
     void updateParticlesOpacity();
 
+private Q_SLOTS:
+    /// Remove the cameras queued by removeCameraFromUI from the camera sets
+    void flushCameraRemovals();
+    /// Use the plane segmentation computed in background, and save it in the project cache
+    void applyPlaneSegmentation();
+
 private:
     void initCameraPointsLocator();
     void updatePointsVisibility();
+    /// Load in advance the images of the cameras sharing the most points with the given one
+    void prefetchNeighbourImages(const int camera);
     void reloadMVGCamerasFromMaya();
+    /// Number of cameras of the set seeing each point, cached by camera set
+    const std::vector<int>& getPointsScore(MVGCameraSetWrapper* cameraSet);
     /// Update members of the camera set based on particle selection
     void updateCamerasFromParticleSelection(bool force=false);
-    /// Update set's MVGCameraSetWrapper members (MVGCameraWrappers)
+    /// Update set's MVGCameraSetWrapper members (camera indexes)
     void updateCameraSetWrapperMembers(const MObject &set);
     /// Use 'wrapper' as current camera set
     void setCurrentCameraSet(MVGCameraSetWrapper *wrapper);
-    MVGCameraWrapper* cameraFromViewName(const QString& viewName);
+    /// Index of the camera displayed in the view, -1 if none
+    int cameraFromViewName(const QString& viewName);
+    void setCameraToView(const int camera, const QString& viewName);
     MVGPanelWrapper* panelFromViewName(const QString& viewName);
 
 private:
@@ -242,18 +260,47 @@ private:
 
     int _currentCameraSetId;
     std::set<int> _particleSelection;
-    std::map<MVGCameraWrapper*, int> _selectionScorePerCamera;
-    std::map<int, std::vector<MVGCameraWrapper*>> _camerasPerPoint;
+    /// number of selected particles seen by each camera, by visibility graph camera index
+    std::vector<int> _selectionScorePerCamera;
+    /// camera indexes by visibility graph camera index (-1 once removed)
+    std::vector<int> _camerasByGraphIndex;
     int _particleSelectionAccuracy;
     int _particleMaxAccuracy;
     bool _filterPoints;
     int _pointsFilteringThreshold;
-
+    /// number of cameras of a camera set seeing each point, for the given set members
+    struct PointsScore
+    {
+        QList<int> cameras;
+        std::vector<int> scores;
+    };
+    std::map<MVGCameraSetWrapper*, PointsScore> _pointsScorePerCameraSet;
+    /// last opacity applied to each particle (0 or 1), empty if unknown
+    std::vector<unsigned char> _particlesOpacity;
+
+    /// cameras of the project, referenced by index by the members below and the camera sets
+    MVGCameraRecords _cameraRecords;
     MVGCameraSetWrapper* _defaultCameraSet;
     MVGCameraSetWrapper* _currentCameraSet;
     MVGCameraSetWrapper* _particleSelectionCameraSet;
 
-    std::map<std::string, MVGCameraWrapper*> _camerasByName;
+    /// camera indexes by dag path at load time
+    std::map<std::string, int> _camerasByName;
+    /// camera node, with its keys in the other camera indexes
+    struct CameraNode
+    {
+        MObjectHandle handle;
+        /// index in _cameraRecords
+        int camera;
+        /// key in _camerasByName (path at load time)
+        std::string name;
+        /// index in _camerasByGraphIndex, -1 if not in the visibility graph
+        int graphIndex;
+    };
+    /// camera nodes, keyed by MObjectHandle::hashCode
+    std::unordered_multimap<unsigned int, CameraNode> _camerasByNode;
+    /// indexes of the removed cameras waiting for flushCameraRemovals
+    std::vector<int> _removedCameras;
     std::map<std::string, MVGMeshWrapper*> _meshesByName;
     std::map<std::string, MVGCameraSetWrapper*> _cameraSetsByName;
     /// map view to active camera
@@ -262,6 +309,11 @@ private:
 
     MCallbackId _cameraPointsLocatorCB;
     std::map<std::string, MCallbackIdArray> _nodeCallbacks;
+
+    /// project cache file of the loaded project, empty if it can't be used
+    std::string _projectCachePath;
+    MVGProjectCacheFile::Source _projectCacheSource;
+    MVGPlaneSegmentationTask _planeSegmentationTask;
 };
 
 } // namespace
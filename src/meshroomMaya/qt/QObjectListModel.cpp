@@ -1,6 +1,14 @@
 #include "QObjectListModel.hpp"
 #include <QQmlEngine>
 
+namespace
+{ // empty namespace
+
+/// over this ratio of moved rows, patchObjectList resets the model instead
+static const double MAX_MOVED_ROWS_RATIO = 0.25;
+
+} // empty namespace
+
 /*!
     \class QObjectListModel
     \brief The QObjectListModel class provides a model that supplies objects to
@@ -115,6 +123,31 @@ void QObjectListModel::setObjectList(QObjectList objects)
         internEmitCountChanged();
 }
 
+/*!
+    Updates the model's internal objects list to \a objects with the minimal
+    set of row removals, insertions and moves, so that attached views keep
+    their delegates (and scrolling position) for the objects that remain.
+
+    Objects are matched by pointer. Kept objects following the same relative
+    order as before (longest increasing subsequence) are not moved. Removed
+    and inserted objects are dereferenced and referenced as in removeAt()
+    and insert(). Falls back to setObjectList() if \a objects contains
+    duplicates, or if more than a quarter of the rows would have to move.
+
+    \sa setObjectList()
+*/
+void QObjectListModel::patchObjectList(const QObjectList& objects)
+{
+    const int oldCount = _objects.count();
+    if(!meshroomMaya::patchRows(*this, _objects, objects, MAX_MOVED_ROWS_RATIO))
+    {
+        setObjectList(objects);
+        return;
+    }
+    if(_objects.count() != oldCount)
+        internEmitCountChanged();
+}
+
 /*!
     Inserts \a object at the end of the model and notifies any views.
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "MVGListModelPatch.hpp"
 #include <QAbstractListModel>
 
 /*
@@ -40,6 +41,7 @@ public:
     QVariant data(const QModelIndex& index, int role) const override;
     QObjectList objectList() const;
     void setObjectList(QObjectList objects);
+    void patchObjectList(const QObjectList& objects);
     void append(QObject* object);
     void append(const QObjectList& objects);
     void insert(int i, QObject* object);
@@ -90,6 +92,10 @@ Q_SIGNALS:
     void countChanged();
 
 private:
+    template <typename Model, typename T>
+    friend bool meshroomMaya::patchRows(Model& model, QList<T>& rows, const QList<T>& target,
+                                        const double maxMovedRatio);
+
     void referenceItem(QObject* obj);
     void dereferenceItem(QObject* obj);
     void internEmitCountChanged();
@@ -28,12 +28,9 @@ Item {
 
     function selectCameras(oldIndex, newIndex) {
         listView.forceActiveFocus()
-        var qlist = [];
-        var begin = Math.min(oldIndex, newIndex);
-        var end = Math.max(oldIndex, newIndex) + 1;
-
-        for(var i = begin; i < end; ++i)
-            qlist[qlist.length] = m.project.currentCameraSet.cameras.get(i).dagPath;
+        // Read the dag paths from the model: don't create the camera wrappers of the whole range
+        var qlist = m.project.currentCameraSet.cameras.getDagPaths(Math.min(oldIndex, newIndex),
+                                                                   Math.max(oldIndex, newIndex));
 
         m.project.addCamerasToIHMSelection(qlist);
         if(m.project.activeSynchro)